@@ -3,36 +3,46 @@
 
 #include <cmath>
 
-class Complex {
+// 复数，T 为 double 或 float；内存布局为交错的 (real, imag)
+template<typename T>
+class ComplexT {
 public:
-    double real, imag;
-    
-    Complex(double r = 0, double i = 0) : real(r), imag(i) {}
-    
-    Complex operator+(const Complex& other) const {
-        return Complex(real + other.real, imag + other.imag);
+    T real, imag;
+
+    ComplexT(T r = 0, T i = 0) : real(r), imag(i) {}
+
+    // 不同精度之间的显式转换
+    template<typename U>
+    explicit ComplexT(const ComplexT<U>& other)
+        : real(static_cast<T>(other.real)), imag(static_cast<T>(other.imag)) {}
+
+    ComplexT operator+(const ComplexT& other) const {
+        return ComplexT(real + other.real, imag + other.imag);
     }
-    
-    Complex operator-(const Complex& other) const {
-        return Complex(real - other.real, imag - other.imag);
+
+    ComplexT operator-(const ComplexT& other) const {
+        return ComplexT(real - other.real, imag - other.imag);
     }
-    
-    Complex operator*(const Complex& other) const {
-        return Complex(real * other.real - imag * other.imag,
-                      real * other.imag + imag * other.real);
+
+    ComplexT operator*(const ComplexT& other) const {
+        return ComplexT(real * other.real - imag * other.imag,
+                        real * other.imag + imag * other.real);
     }
-    
-    Complex operator/(double d) const {
-        return Complex(real / d, imag / d);
+
+    ComplexT operator/(T d) const {
+        return ComplexT(real / d, imag / d);
     }
-    
-    double magnitude() const {
-        return sqrt(real * real + imag * imag);
+
+    T magnitude() const {
+        return std::sqrt(real * real + imag * imag);
     }
-    
-    double phase() const {
-        return atan2(imag, real);
+
+    T phase() const {
+        return std::atan2(imag, real);
     }
 };
 
-#endif // COMPLEX_H
\ No newline at end of file
+using Complex = ComplexT<double>;
+using ComplexF = ComplexT<float>;
+
+#endif // COMPLEX_H
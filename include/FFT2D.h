@@ -0,0 +1,109 @@
+#ifndef FFT_2D_H
+#define FFT_2D_H
+
+#include "Complex.h"
+#include "Image.h"
+
+// 二维实数FFT
+// 实数图像的频谱满足共轭对称 X[ky][kx] = conj(X[-ky][-kx])，因此只保存 kx ∈ [0, W/2] 的半频谱：
+// 宽 W/2+1、高 H，自然顺序（直流分量在(0,0)）。
+// 行变换把两行实数据打包成一行复数数据做一次复数FFT，列变换只处理半频谱的 W/2+1 列。
+// 行、列两遍变换都在 ThreadPool::global() 上并行执行。
+// T 为计算精度（double 或 float），在 FFT2D.cpp 中显式实例化。
+namespace FFT2D {
+    // 半频谱宽度
+    inline int halfWidth(int width) { return width / 2 + 1; }
+
+    // 频率下标 k（0..n-1）相对直流分量的带符号偏移，与 fftShift 后到中心的距离一致
+    inline int centeredOffset(int k, int n) { return k < n - n / 2 ? k : k - n; }
+
+    // 实数图像 -> 半频谱
+    template<typename T>
+    void forwardR2C(const Image<T>& input, Spectrum<ComplexT<T>>& output);
+
+    // 半频谱 -> 实数图像（含 1/(W*H) 归一化）
+    // width 为原图宽度：半频谱宽度 W/2+1 无法区分 W 的奇偶
+    template<typename T>
+    void inverseC2R(const Spectrum<ComplexT<T>>& input, int width, Image<T>& output);
+
+    // 同上，列变换的中间结果写入调用者持有的 work（复用其容量，重复调用不再分配内存）。
+    // activeColumns：调用者保证 kx >= activeColumns 的列全为零（例如低通滤波后），
+    // 这些列既不读取也不做列变换；负数表示所有列都可能非零
+    template<typename T>
+    void inverseC2R(const Spectrum<ComplexT<T>>& input, int width, Image<T>& output,
+                    Spectrum<ComplexT<T>>& work, int activeColumns = -1);
+
+    // 行变换：input 的第 [yBegin, yEnd) 行 -> output 的第 0 .. yEnd-yBegin-1 行（只做行方向的变换）。
+    // output 须已有至少 yEnd-yBegin 行、W/2+1 列。供按条带调度的变换（如外存FFT）使用
+    template<typename T>
+    void forwardRows(const Image<T>& input, int yBegin, int yEnd, Spectrum<ComplexT<T>>& output);
+
+    // 在 ThreadPool::global() 的每个线程上预先分配 width × height 变换所需的线程局部缓冲区
+    // （行、列块缓冲区和行列两个一维计划的临时缓冲区），之后同尺寸的变换不再分配内存
+    template<typename T>
+    void reserveScratch(int width, int height);
+    // reserveScratch 在每个线程上分配的字节数（上界），用于内存预算
+    template<typename T>
+    size_t scratchBytes(int width, int height);
+
+    // 逆行变换：input（已完成列逆变换）的全部行 -> output 的第 yBegin 行起，含 1/W 归一化；
+    // kx >= activeColumns 的系数按零处理。output 须已有足够的行
+    template<typename T>
+    void inverseRows(const Spectrum<ComplexT<T>>& input, int width, int activeColumns, Image<T>& output, int yBegin);
+
+    // 按需将半频谱展开为完整频谱中的一个系数，(x, y) 为 fftShift 后的中心化坐标
+    template<typename T>
+    ComplexT<T> centeredCoefficient(const Spectrum<ComplexT<T>>& half, int width, int x, int y);
+
+    // 半频谱上的中心化视图：不复制数据，按下标映射读取，相当于对完整频谱做 fftShift。
+    // 直流分量位于 (W/2, H/2)，奇数尺寸同样正确（正半轴比负半轴多一个频率）。
+    // 视图只引用半频谱，使用期间半频谱必须保持有效且不被修改尺寸。
+    template<typename T>
+    class CenteredSpectrumView {
+    public:
+        CenteredSpectrumView() : half(nullptr), fullWidth(0) {}
+        CenteredSpectrumView(const Spectrum<ComplexT<T>>& spectrum, int width)
+            : half(&spectrum), fullWidth(width) {}
+
+        bool empty() const { return half == nullptr || half->empty(); }
+        int width() const { return fullWidth; }
+        int height() const { return half ? half->height() : 0; }
+
+        ComplexT<T> operator()(int x, int y) const {
+            return centeredCoefficient(*half, fullWidth, x, y);
+        }
+
+        // 展开中心化坐标下的第 y 行（共 width() 个系数），按两段连续区间读取，不做逐元素取模
+        void row(int y, ComplexT<T>* out) const {
+            int h = half->height();
+            int ky = (y + h - h / 2) % h;
+            const ComplexT<T>* direct = half->row(ky);
+            const ComplexT<T>* mirror = half->row((h - ky) % h);
+            int halfCount = half->width();
+            int shift = fullWidth - fullWidth / 2;  // x = 0 对应的频率下标
+
+            // x ∈ [0, W/2)：kx = x + shift ∈ [shift, W)，位于负频率一侧，由共轭对称得到
+            for (int x = 0; x < fullWidth / 2; x++) {
+                int kx = x + shift;
+                if (kx < halfCount) {
+                    out[x] = direct[kx];
+                } else {
+                    const ComplexT<T>& c = mirror[fullWidth - kx];
+                    out[x] = ComplexT<T>(c.real, -c.imag);
+                }
+            }
+            // x ∈ [W/2, W)：kx = x - W/2 ∈ [0, shift)，都在半频谱内
+            // （从 direct 本身索引：direct - W/2 会越过分配区起点，即使只访问范围内的元素也是未定义行为）
+            int offset = fullWidth / 2;
+            for (int x = offset; x < fullWidth; x++) {
+                out[x] = direct[x - offset];
+            }
+        }
+
+    private:
+        const Spectrum<ComplexT<T>>* half;
+        int fullWidth;
+    };
+}
+
+#endif // FFT_2D_H
@@ -0,0 +1,324 @@
+#ifndef FFT_CODELETS_H
+#define FFT_CODELETS_H
+
+#include <utility>
+#include "Complex.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define FFT_FORCE_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+    #define FFT_FORCE_INLINE __forceinline
+#else
+    #define FFT_FORCE_INLINE inline
+#endif
+
+// 小尺寸FFT的编译期展开实现（codelet）
+// 长度 N 为编译期常量（2..64 的2的幂次），位反转置换和每级蝶形都由模板完全展开，
+// 旋转因子在编译期求值，运行时没有循环控制和旋转因子表访问。
+// FFTPlan 对 N <= MaxSize 的长度直接调用 transform，对更长的序列在位反转后
+// 先用 leaves 完成前 log2(LeafSize) 级，再由SIMD内核完成剩余各级。
+// 含因子 3、5 的长度（MixedSizes）另有按时间抽取递归展开的跨步 codelet，
+// 混合基计划用它完成整个变换或最后几级（stridedLeaves）。
+namespace FFTCodelets {
+    constexpr int MaxSize = 64;
+    constexpr int LeafSize = 16;
+    // 混合基 codelet 支持的长度，由大到小
+    constexpr int MixedSizes[] = {60, 45, 30, 20, 15, 12, 10, 9, 6, 5, 3};
+    // 作为更长序列的叶子时的最大长度：更大的 codelet 局部数组放不进寄存器，
+    // 跨步执行反而比逐级的 Stockham 慢；整个序列就是 codelet 长度时不受此限制
+    constexpr int MixedLeafMax = 15;
+
+    namespace detail {
+        constexpr double PI = 3.14159265358979323846;
+
+        // 编译期 sin/cos（泰勒级数，|x| <= π 时达到双精度）
+        constexpr double sinSeries(double x) {
+            double term = x, sum = x;
+            for (int k = 1; k < 24; k++) {
+                term *= -x * x / ((2.0 * k) * (2.0 * k + 1.0));
+                sum += term;
+            }
+            return sum;
+        }
+
+        constexpr double cosSeries(double x) {
+            double term = 1.0, sum = 1.0;
+            for (int k = 1; k < 24; k++) {
+                term *= -x * x / ((2.0 * k - 1.0) * (2.0 * k));
+                sum += term;
+            }
+            return sum;
+        }
+
+        // exp(-2πi·j/n) 的实部和虚部，0 <= j < n/2
+        template<int J, int N>
+        struct Twiddle {
+            static constexpr double angle = -2.0 * PI * J / N;
+            static constexpr double real = cosSeries(angle);
+            static constexpr double imag = sinSeries(angle);
+        };
+
+        constexpr int bitReverse(int i, int n) {
+            int reversed = 0;
+            for (int bit = 1; bit < n; bit <<= 1) {
+                reversed = (reversed << 1) | (i & 1);
+                i >>= 1;
+            }
+            return reversed;
+        }
+
+        // 位反转置换中的一次交换
+        template<typename T, int N, int I>
+        FFT_FORCE_INLINE void swapBitReversed(ComplexT<T>* data) {
+            constexpr int J = bitReverse(I, N);
+            if constexpr (I < J) {
+                ComplexT<T> tmp = data[I];
+                data[I] = data[J];
+                data[J] = tmp;
+            }
+        }
+
+        template<typename T, int N, std::size_t... Is>
+        FFT_FORCE_INLINE void bitReversePermute(ComplexT<T>* data, std::index_sequence<Is...>) {
+            (swapBitReversed<T, N, static_cast<int>(Is)>(data), ...);
+        }
+
+        // 一个 radix-2 DIT 蝶形：a[J] 与 a[J+Half]，旋转因子 exp(-2πi·J/(2·Half))
+        template<typename T, int Half, int J>
+        FFT_FORCE_INLINE void butterfly(ComplexT<T>* a) {
+            ComplexT<T> u = a[J];
+            ComplexT<T> b = a[J + Half];
+            ComplexT<T> v;
+            if constexpr (J == 0) {
+                v = b;
+            } else if constexpr (4 * J == 2 * Half) {
+                v = ComplexT<T>(b.imag, -b.real);  // 乘以 -i
+            } else {
+                constexpr T wr = static_cast<T>(Twiddle<J, 2 * Half>::real);
+                constexpr T wi = static_cast<T>(Twiddle<J, 2 * Half>::imag);
+                v = ComplexT<T>(b.real * wr - b.imag * wi, b.real * wi + b.imag * wr);
+            }
+            a[J] = u + v;
+            a[J + Half] = u - v;
+        }
+
+        template<typename T, int Half, std::size_t... Js>
+        FFT_FORCE_INLINE void butterflyGroup(ComplexT<T>* a, std::index_sequence<Js...>) {
+            (butterfly<T, Half, static_cast<int>(Js)>(a), ...);
+        }
+
+        // 一级蝶形：长度 N 的块内共 N/(2·Half) 组
+        template<typename T, int N, int Half, std::size_t... Gs>
+        FFT_FORCE_INLINE void stage(ComplexT<T>* block, std::index_sequence<Gs...>) {
+            (butterflyGroup<T, Half>(block + Gs * 2 * Half, std::make_index_sequence<Half>{}), ...);
+        }
+
+        // 半长从 Half 到 N/2 的所有级
+        template<typename T, int N, int Half>
+        FFT_FORCE_INLINE void stages(ComplexT<T>* block) {
+            if constexpr (Half < N) {
+                stage<T, N, Half>(block, std::make_index_sequence<N / (2 * Half)>{});
+                stages<T, N, Half * 2>(block);
+            }
+        }
+
+        // 任意指数的 exp(-2πi·E/N)：E 先对 N 取模，角度折算到 [-π, π] 以保证级数精度
+        template<int E, int N>
+        struct Root {
+            static constexpr int e = E % N;
+            static constexpr double angle = 2 * e > N ? 2.0 * PI * (N - e) / N : -2.0 * PI * e / N;
+            static constexpr double real = cosSeries(angle);
+            static constexpr double imag = sinSeries(angle);
+        };
+
+        // c · exp(-2πi·E/N)，E ≡ 0 时不做乘法
+        template<typename T, int E, int N>
+        FFT_FORCE_INLINE ComplexT<T> rotate(const ComplexT<T>& c) {
+            if constexpr (E % N == 0) {
+                return c;
+            } else {
+                constexpr T wr = static_cast<T>(Root<E, N>::real);
+                constexpr T wi = static_cast<T>(Root<E, N>::imag);
+                return ComplexT<T>(c.real * wr - c.imag * wi, c.real * wi + c.imag * wr);
+            }
+        }
+
+        // 乘以 -i
+        template<typename T>
+        FFT_FORCE_INLINE ComplexT<T> timesMinusI(const ComplexT<T>& c) {
+            return ComplexT<T>(c.imag, -c.real);
+        }
+
+        // R 点DFT（R = 2/3/4/5）：输入 a[0..R)，结果写入 out[t·stride]
+        template<typename T, int R>
+        FFT_FORCE_INLINE void radix(const ComplexT<T>* a, ComplexT<T>* out, int stride) {
+            if constexpr (R == 2) {
+                out[0] = a[0] + a[1];
+                out[stride] = a[0] - a[1];
+            } else if constexpr (R == 3) {
+                // X1,2 = a0 - (a1 + a2)/2 ∓ i·sin(π/3)·(a1 - a2)
+                constexpr T s = static_cast<T>(sinSeries(PI / 3));
+                ComplexT<T> sum = a[1] + a[2];
+                ComplexT<T> diff = a[1] - a[2];
+                ComplexT<T> m(a[0].real - T(0.5) * sum.real, a[0].imag - T(0.5) * sum.imag);
+                ComplexT<T> n = timesMinusI(ComplexT<T>(s * diff.real, s * diff.imag));
+                out[0] = a[0] + sum;
+                out[stride] = m + n;
+                out[2 * stride] = m - n;
+            } else if constexpr (R == 4) {
+                ComplexT<T> t0 = a[0] + a[2];
+                ComplexT<T> t1 = a[0] - a[2];
+                ComplexT<T> t2 = a[1] + a[3];
+                ComplexT<T> t3 = timesMinusI(a[1] - a[3]);
+                out[0] = t0 + t2;
+                out[stride] = t1 + t3;
+                out[2 * stride] = t0 - t2;
+                out[3 * stride] = t1 - t3;
+            } else {
+                static_assert(R == 5, "radix must be 2, 3, 4 or 5");
+                // a[r] 与 a[5-r] 成对：和乘余弦、差乘正弦
+                constexpr T c1 = static_cast<T>(cosSeries(2 * PI / 5));
+                constexpr T c2 = static_cast<T>(cosSeries(4 * PI / 5));
+                constexpr T s1 = static_cast<T>(sinSeries(2 * PI / 5));
+                constexpr T s2 = static_cast<T>(sinSeries(4 * PI / 5));
+                ComplexT<T> b1 = a[1] + a[4], b2 = a[2] + a[3];
+                ComplexT<T> d1 = a[1] - a[4], d2 = a[2] - a[3];
+                ComplexT<T> m1(a[0].real + c1 * b1.real + c2 * b2.real, a[0].imag + c1 * b1.imag + c2 * b2.imag);
+                ComplexT<T> m2(a[0].real + c2 * b1.real + c1 * b2.real, a[0].imag + c2 * b1.imag + c1 * b2.imag);
+                ComplexT<T> n1 = timesMinusI(ComplexT<T>(s1 * d1.real + s2 * d2.real, s1 * d1.imag + s2 * d2.imag));
+                ComplexT<T> n2 = timesMinusI(ComplexT<T>(s2 * d1.real - s1 * d2.real, s2 * d1.imag - s1 * d2.imag));
+                out[0] = a[0] + b1 + b2;
+                out[stride] = m1 + n1;
+                out[2 * stride] = m2 + n2;
+                out[3 * stride] = m2 - n2;
+                out[4 * stride] = m1 - n1;
+            }
+        }
+
+        // 混合基分解时先取的基数：4、3、5、2 中第一个能整除 N 的（N 本身是基数时为 N）
+        constexpr int firstRadix(int n) {
+            if (n <= 5) {
+                return n;
+            }
+            return n % 4 == 0 ? 4 : n % 3 == 0 ? 3 : n % 5 == 0 ? 5 : 2;
+        }
+
+        template<typename T, int N>
+        FFT_FORCE_INLINE void mixedDFT(const ComplexT<T>* in, int inStride, ComplexT<T>* out, int outStride);
+
+        // 第 K 组蝶形：Y_r[K]·ω_N^(r·K)（r < R）做 R 点DFT，写入 X[K + M·t]
+        template<typename T, int N, int R, int K, std::size_t... Rs>
+        FFT_FORCE_INLINE void mixedCombine(const ComplexT<T>* sub, ComplexT<T>* out, int stride,
+                                           std::index_sequence<Rs...>) {
+            constexpr int M = N / R;
+            const ComplexT<T> a[R] = { rotate<T, static_cast<int>(Rs) * K, N>(sub[Rs * M + K])... };
+            radix<T, R>(a, out + static_cast<size_t>(K) * stride, M * stride);
+        }
+
+        template<typename T, int N, int R, std::size_t... Ks>
+        FFT_FORCE_INLINE void mixedCombineAll(const ComplexT<T>* sub, ComplexT<T>* out, int stride,
+                                              std::index_sequence<Ks...>) {
+            (mixedCombine<T, N, R, static_cast<int>(Ks)>(sub, out, stride, std::make_index_sequence<R>{}), ...);
+        }
+
+        template<typename T, int N, int R, std::size_t... Rs>
+        FFT_FORCE_INLINE void mixedSplit(const ComplexT<T>* in, int inStride, ComplexT<T>* sub,
+                                         std::index_sequence<Rs...>) {
+            constexpr int M = N / R;
+            (mixedDFT<T, M>(in + Rs * inStride, R * inStride, sub + Rs * M, 1), ...);
+        }
+
+        template<typename T, std::size_t... Rs>
+        FFT_FORCE_INLINE void gather(const ComplexT<T>* in, int stride, ComplexT<T>* a, std::index_sequence<Rs...>) {
+            ((a[Rs] = in[Rs * stride]), ...);
+        }
+
+        // N 点DFT：输入 in[j·inStride]，输出 out[k·outStride]（自然顺序）。
+        // 按时间抽取：N = R·M，先对 R 个子序列 in[r + R·j] 做 M 点DFT，再做 M 组 R 点蝶形。
+        // 全部输入读入局部数组后才写输出，in 与 out 可以相同
+        template<typename T, int N>
+        FFT_FORCE_INLINE void mixedDFT(const ComplexT<T>* in, int inStride, ComplexT<T>* out, int outStride) {
+            constexpr int R = firstRadix(N);
+            if constexpr (R == N) {
+                ComplexT<T> a[N];
+                gather<T>(in, inStride, a, std::make_index_sequence<N>{});
+                radix<T, N>(a, out, outStride);
+            } else {
+                ComplexT<T> sub[N];
+                mixedSplit<T, N, R>(in, inStride, sub, std::make_index_sequence<R>{});
+                mixedCombineAll<T, N, R>(sub, out, outStride, std::make_index_sequence<N / R>{});
+            }
+        }
+
+        template<typename T, int N>
+        void stridedLeaves(ComplexT<T>* data, int stride) {
+            for (int q = 0; q < stride; q++) {
+                mixedDFT<T, N>(data + q, stride, data + q, stride);
+            }
+        }
+    }
+
+    // 自然顺序输入的完整 N 点正变换（原地）
+    template<typename T, int N>
+    void transform(ComplexT<T>* data) {
+        static_assert(N >= 2 && N <= MaxSize && (N & (N - 1)) == 0, "codelet size must be a power of two in [2, 64]");
+        detail::bitReversePermute<T, N>(data, std::make_index_sequence<N>{});
+        detail::stages<T, N, 1>(data);
+    }
+
+    // 对已位反转的长度 n 的序列，逐块（每块 N 个元素）完成前 log2(N) 级蝶形
+    template<typename T, int N>
+    void leaves(ComplexT<T>* data, int n) {
+        static_assert(N >= 2 && N <= MaxSize && (N & (N - 1)) == 0, "codelet size must be a power of two in [2, 64]");
+        for (int i = 0; i < n; i += N) {
+            detail::stages<T, N, 1>(data + i);
+        }
+    }
+
+    // 对 stride 个交错的子序列 data[q + stride·j]（q < stride，j < leaf）各做一次 leaf 点DFT，
+    // 结果原地按自然顺序写回；leaf 须为 MixedSizes 之一，否则返回 false
+    template<typename T>
+    bool stridedLeaves(ComplexT<T>* data, int leaf, int stride) {
+        switch (leaf) {
+            case 3:  detail::stridedLeaves<T, 3>(data, stride);  return true;
+            case 5:  detail::stridedLeaves<T, 5>(data, stride);  return true;
+            case 6:  detail::stridedLeaves<T, 6>(data, stride);  return true;
+            case 9:  detail::stridedLeaves<T, 9>(data, stride);  return true;
+            case 10: detail::stridedLeaves<T, 10>(data, stride); return true;
+            case 12: detail::stridedLeaves<T, 12>(data, stride); return true;
+            case 15: detail::stridedLeaves<T, 15>(data, stride); return true;
+            case 20: detail::stridedLeaves<T, 20>(data, stride); return true;
+            case 30: detail::stridedLeaves<T, 30>(data, stride); return true;
+            case 45: detail::stridedLeaves<T, 45>(data, stride); return true;
+            case 60: detail::stridedLeaves<T, 60>(data, stride); return true;
+            default: return false;
+        }
+    }
+
+    // 长度 n 的混合基计划使用的叶子长度：n 本身是 codelet 长度时为 n，
+    // 否则为 MixedSizes 中不超过 MixedLeafMax 且能整除 n 的最大者，没有时返回 1
+    inline int mixedLeafSize(int n) {
+        for (int size : MixedSizes) {
+            if (n == size || (size <= MixedLeafMax && n % size == 0)) {
+                return size;
+            }
+        }
+        return 1;
+    }
+
+    // 运行时长度分派到对应的 transform，n 不在支持范围内时返回 false
+    template<typename T>
+    bool transform(ComplexT<T>* data, int n) {
+        switch (n) {
+            case 2:  transform<T, 2>(data);  return true;
+            case 4:  transform<T, 4>(data);  return true;
+            case 8:  transform<T, 8>(data);  return true;
+            case 16: transform<T, 16>(data); return true;
+            case 32: transform<T, 32>(data); return true;
+            case 64: transform<T, 64>(data); return true;
+            default: return false;
+        }
+    }
+}
+
+#endif // FFT_CODELETS_H
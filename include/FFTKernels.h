@@ -0,0 +1,34 @@
+#ifndef FFT_KERNELS_H
+#define FFT_KERNELS_H
+
+// SIMD指令集级别（从低到高）
+enum class SimdLevel {
+    Scalar,
+    SSE2,
+    AVX2,     // AVX2 + FMA
+    AVX512    // AVX-512F
+};
+
+// FFT蝶形运算内核
+// 复数按实部、虚部交错存放（与 Complex 的内存布局一致）。
+// 运行时根据CPU特性选择最快的实现，标量版本作为回退和参考实现。
+namespace FFTKernels {
+    // 对长度为 n 的序列执行一级 radix-2 DIT 蝶形：
+    // 每组 [i, i+half) 与 [i+half, i+2*half) 配对，twiddles 为该级的 half 个旋转因子
+    void radix2Pass(double* data, const double* twiddles, int n, int half);
+    void radix2Pass(float* data, const float* twiddles, int n, int half);
+
+    // 标量参考实现
+    void radix2PassScalar(double* data, const double* twiddles, int n, int half);
+    void radix2PassScalar(float* data, const float* twiddles, int n, int half);
+
+    // 当前CPU支持的最高级别
+    SimdLevel detectSimdLevel();
+    // 当前使用的级别
+    SimdLevel activeSimdLevel();
+    // 强制指定级别（超出CPU支持范围时取CPU支持的最高级别），返回实际生效的级别
+    SimdLevel setSimdLevel(SimdLevel level);
+    const char* simdLevelName(SimdLevel level);
+}
+
+#endif // FFT_KERNELS_H
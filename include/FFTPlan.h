@@ -0,0 +1,105 @@
+#ifndef FFT_PLAN_H
+#define FFT_PLAN_H
+
+#include <vector>
+#include <memory>
+#include "Complex.h"
+
+// 一维FFT计划
+// 构造时一次性计算好置换表、旋转因子等，之后可对同样长度的数据反复执行。
+// 根据长度自动选择算法：
+//   - 2的幂次：原地 radix-2（位反转 + SIMD蝶形）
+//   - 只含因子 2/3/5/7：Stockham 自动排序混合基算法
+//   - 含更大的素因子：Bluestein 算法，转化为2的幂次长度的循环卷积
+//   - 长度不小于 FourStepThreshold 且只含因子 2/3/5/7：四步法（Bailey），
+//     分解为 n1×n2 的矩阵，每次只对能放进缓存的短序列做FFT
+// 计划对象创建后只读，可以在多个线程间共享。
+// T 为 double 或 float，旋转因子均以双精度计算后再转换，float 计划只损失存储精度。
+template<typename T>
+class FFTPlanT {
+public:
+    enum class Algorithm {
+        Radix2,
+        MixedRadix,
+        Bluestein,
+        FourStep
+    };
+
+    // 使用四步法的最小长度（double 为 16MB）。更短的序列在 L2/L3 中，radix-2 的跨步访问代价不大，
+    // 四步法额外的两次分块转置反而更慢；超过该长度后 radix-2 后几级每次都要访问主存
+    static constexpr int FourStepThreshold = 1 << 20;
+
+    using ComplexType = ComplexT<T>;
+
+    explicit FFTPlanT(int n);
+
+    int size() const { return n; }
+    Algorithm algorithm() const { return algo; }
+
+    // 原地正变换
+    void forward(ComplexType* data) const;
+    // 原地逆变换（含1/n归一化）
+    void inverse(ComplexType* data) const;
+    // 为调用线程预先分配执行本计划（含子计划）所需的临时缓冲区
+    void reserveScratch() const;
+    // 执行本计划（含子计划）时每个线程需要的临时缓冲区字节数（上界，用于内存预算）
+    size_t scratchBytes() const;
+
+    // 从全局缓存中获取指定长度的计划，不存在时创建
+    static std::shared_ptr<const FFTPlanT> get(int n);
+    // 清空计划缓存
+    static void clearCache();
+
+private:
+    // 混合基算法的一级
+    struct Stage {
+        int radix;
+        int length;            // 本级处理的子序列长度
+        int stride;            // 子序列间隔（本级之前各级基数之积）
+        size_t twiddleOffset;  // 本级旋转因子在 twiddles 中的起始位置
+    };
+
+    int n;
+    Algorithm algo;
+
+    // radix-2
+    std::vector<int> bitReversal;  // bitReversal[i] 为 i 的位反转下标
+    // radix-2: 各级旋转因子连续存放，半长为 h 的一级占用 [h-1, 2h-1)，第 j 项为 exp(-2πi·j/(2h))
+    // 混合基: 每级 (length/radix) × (radix-1) 个旋转因子
+    std::vector<ComplexType> twiddles;
+
+    // 混合基：各级 Stockham 之后剩余的 leafSize 点由 FFTCodelets::stridedLeaves 完成（1 表示没有）
+    std::vector<Stage> stages;
+    int leafSize = 1;
+
+    // 四步法: n = n1 × n2，twiddles 存放 exp(-2πi·j2·k1/n)，下标 j2·n1 + k1
+    int n1 = 0;
+    int n2 = 0;
+    std::shared_ptr<const FFTPlanT> plan1;
+    std::shared_ptr<const FFTPlanT> plan2;
+
+    // Bluestein
+    std::shared_ptr<const FFTPlanT> convolutionPlan;
+    std::vector<ComplexType> chirp;          // exp(-πi·k²/n)
+    std::vector<ComplexType> chirpSpectrum;  // 卷积核的FFT（已含 1/m 归一化）
+
+    void initRadix2();
+    void initMixedRadix();
+    void initBluestein();
+    void initFourStep();
+
+    void execute(ComplexType* data) const;
+    void executeRadix2(ComplexType* data) const;
+    void executeMixedRadix(ComplexType* data) const;
+    void executeBluestein(ComplexType* data) const;
+    void executeFourStep(ComplexType* data) const;
+};
+
+// 实现位于 FFTPlan.cpp，只对 double 和 float 显式实例化
+extern template class FFTPlanT<double>;
+extern template class FFTPlanT<float>;
+
+using FFTPlan = FFTPlanT<double>;
+using FFTPlanF = FFTPlanT<float>;
+
+#endif // FFT_PLAN_H
@@ -0,0 +1,68 @@
+#ifndef FILTER_CHAIN_H
+#define FILTER_CHAIN_H
+
+#include <vector>
+#include <functional>
+#include <cstddef>
+#include "Complex.h"
+#include "Image.h"
+#include "RadialFilter.h"
+
+// 滤波链：把多个频域操作组合起来，对半频谱一次遍历完成
+// 所有阶段都是逐系数的实数增益，彼此可交换，应用时合并为每个系数的一次乘法：
+//   - 理想径向滤波（掩膜）按整数平方阈值求交，合并为每行一个保留区间；
+//   - 平滑径向滤波各自查表（RadialTransferLUT），支撑范围同样参与求交；
+//   - 常数增益预先相乘；
+//   - 陷波只处理以陷波中心为圆心的包围盒内的系数；
+//   - 自定义传递函数逐系数调用。
+// 结果只需一次逆变换；保留区间之外的列全为零，逆变换可以跳过。
+class FilterChain {
+public:
+    // 自定义传递函数：参数为中心化频率坐标 (u, v)，返回实数增益
+    // 为使逆变换结果为实数，应满足 f(u, v) == f(-u, -v)
+    using TransferFunction = std::function<double(int u, int v)>;
+
+    // 径向滤波，截止比例按 ImageProcessor 的约定换算为半径
+    FilterChain& addRadial(const FilterSpec& spec);
+    // 常数增益
+    FilterChain& addGain(double gain);
+    // 陷波：去除以中心化坐标 (u, v) 及其共轭对称点 (-u, -v) 为中心、半径 radius 内的系数
+    // smooth 为 true 时使用高斯陷波 1 - exp(-d²/2r²)，否则为理想陷波
+    FilterChain& addNotch(int u, int v, double radius, bool smooth = false);
+    // 自定义传递函数
+    FilterChain& addCustom(TransferFunction function);
+
+    // 移除全部阶段（保留已建立的查找表，参数不变时不会重建）
+    void clear();
+    bool empty() const { return stageCount() == 0; }
+    size_t stageCount() const { return radialCount + gains.size() + notches.size() + customs.size(); }
+
+    // 对半频谱 input 应用全部阶段并写入 output；width 为原图宽度，radiusScale 为截止比例 1 对应的半径
+    // 返回 output 中可能非零的列数，可直接作为 FFT2D::inverseC2R 的 activeColumns
+    int apply(const Spectrum<Complex>& input, int width, double radiusScale, Spectrum<Complex>& output);
+
+private:
+    struct RadialStage {
+        FilterSpec spec;
+        RadialTransferLUT lut;
+        double builtScale = -1.0;        // 查找表建立时的参数，变化时重建
+        long long builtMaxSquared = -1;
+        FilterSpec builtSpec;
+    };
+
+    struct Notch {
+        int u;
+        int v;
+        double radius;
+        bool smooth;
+    };
+
+    std::vector<RadialStage> radials;    // 前 radialCount 项有效
+    size_t radialCount = 0;
+    std::vector<double> gains;
+    std::vector<Notch> notches;
+    std::vector<TransferFunction> customs;
+    std::vector<const RadialTransferLUT*> activeTables;
+};
+
+#endif // FILTER_CHAIN_H
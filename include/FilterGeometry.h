@@ -0,0 +1,50 @@
+#ifndef FILTER_GEOMETRY_H
+#define FILTER_GEOMETRY_H
+
+#include <vector>
+#include <memory>
+#include "Complex.h"
+#include "Image.h"
+
+// 半频谱（宽 W/2+1、高 H，自然顺序）上各系数到直流分量的几何关系
+// 系数 (kx, y) 到直流的平方距离 d² = kx² + dy²（dy = FFT2D::centeredOffset(y, H)）是整数，
+// 因此径向滤波只需把半径换算成整数平方阈值，再按行求出满足条件的 kx 区间（每行一次开方），
+// 内层循环只剩整段复制或置零。行 y 与行 H-y 的 |dy| 相同，上下两半共用同一组 dy²。
+// 几何信息只与尺寸有关，按尺寸缓存；对象创建后只读，可以在多个线程间共享。
+class FilterGeometry {
+public:
+    FilterGeometry(int width, int height);
+
+    int width() const { return fullWidth; }
+    int height() const { return fullHeight; }
+    int halfWidth() const { return half; }
+
+    // 第 y 行的 dy²
+    long long rowOffsetSquared(int y) const { return rowOffsetSq[y]; }
+
+    // 满足 sqrt(d²) <= radius 的最大整数 d²；radius < 0 时返回 -1（没有系数满足）
+    static long long squaredRadiusAtMost(double radius);
+    // 满足 sqrt(d²) < radius 的最大整数 d²；radius <= 0 时返回 -1
+    static long long squaredRadiusBelow(double radius);
+
+    // 第 y 行中 kx² + dy² <= threshold 的系数个数，这些系数恰好占据 kx ∈ [0, count)
+    int columnsWithin(int y, long long threshold) const;
+
+    // 径向选择：dst 中保留 src 里满足 zeroAtMost < d² <= keepAtMost 的系数，其余置零
+    // 每行满足条件的系数是一段连续的 kx 区间，按行整段置零/复制，不逐点计算距离
+    void select(const Spectrum<Complex>& src, Spectrum<Complex>& dst,
+                long long zeroAtMost, long long keepAtMost) const;
+
+    // 从全局缓存中获取指定尺寸的几何信息，不存在时创建
+    static std::shared_ptr<const FilterGeometry> get(int width, int height);
+    // 清空缓存
+    static void clearCache();
+
+private:
+    int fullWidth;
+    int fullHeight;
+    int half;
+    std::vector<long long> rowOffsetSq;
+};
+
+#endif // FILTER_GEOMETRY_H
@@ -11,6 +11,7 @@
 
 #include "ImageProcessor.h"
 #include "OpenGLRenderer.h"
+#include "PreviewWorker.h"
 
 // OpenGL相关
 #include <GL/glew.h>
@@ -18,7 +19,6 @@
 
 // 前向声明
 class ImageProcessor;
-class Complex;
 
 // ImGui相关
 #include "imgui/imgui.h"
@@ -72,27 +72,42 @@ private:
     GLuint frequencyMagnitudeTexture;
     GLuint frequencyPhaseTexture;
     GLuint filteredImageTexture;
+    std::vector<GLuint> filteredLevelTextures;  // 逐级细化预览中各级低分辨率结果的纹理
+    int filteredPreviewLevel;                   // 当前显示的级别，0 为原始分辨率
     DisplayMode currentDisplayMode;
     ColorMap currentColorMap;
+    std::vector<unsigned char> colorBuffer;  // 上传纹理用的RGBA缓冲区，跨帧复用
     
     // 滤波器参数
     int filterType;
+    int filterShape;          // FilterShape：理想/高斯/巴特沃斯/升余弦
+    int butterworthOrder;
+    float raisedCosineRolloff;
     float lowPassCutoff;
     float highPassCutoff;
     float bandPassLow;
     float bandPassHigh;
     bool autoApplyFilter;
+    bool useBandCache;        // 频带缓存预览模式
+    int bandCacheBands;
+    bool notchEnabled;        // 附加陷波：与当前滤波器组合为滤波链
+    int notchU;               // 陷波中心（中心化频率坐标）
+    int notchV;
+    float notchRadius;
+    bool notchSmooth;
+    bool useTiledFilter;      // 分块滤波：不使用全图频谱，全图FFT超出内存预算时自动启用
+    FilterChain filterChain;  // 跨帧复用，参数不变时查找表不重建（只在预览线程中使用）
+    PreviewWorker previewWorker;  // 滤波预览在后台线程中计算，先于 processor 析构
+    
+    // 单/双精度对比结果
+    PrecisionReport precisionReport;
+    
+    // 按需计算的频谱数值诊断
+    NumericDiagnostics spectrumDiagnostics;
+    bool hasSpectrumDiagnostics;
     
     // 图像统计
-    struct ImageStats {
-        double mse;
-        double psnr;
-        double ssim;
-        double meanValue;
-        double stdValue;
-        double minValue;
-        double maxValue;
-    } originalStats, filteredStats;
+    ImageStats originalStats, filteredStats;
     
     // 文件路径
     std::string currentImagePath;
@@ -109,14 +124,24 @@ private:
     // 私有方法
     void initializeGUI();
     void setupCallbacks();
-    GLuint createTextureFromImage(const std::vector<std::vector<double>>& image, 
+    GLuint createTextureFromImage(const Image<double>& image, 
                                   int width, int height, ColorMap colorMap);
+    void updateTextureFromImage(GLuint& texture, const Image<double>& image,
+                                int width, int height, ColorMap colorMap);
+    // 按颜色映射生成 RGBA 数据（不访问 OpenGL，可以在预览线程中调用）
+    static void fillColorBuffer(const Image<double>& image, int width, int height, ColorMap colorMap,
+                                std::vector<unsigned char>& buffer);
+    // 上传 RGBA 数据：尺寸不变时覆盖已有纹理，否则重建
+    void uploadTexture(GLuint& texture, const unsigned char* rgba, int width, int height);
+    void pollFilterPreview();
+    // 滤波后图像当前显示的纹理（逐级细化过程中可能是低分辨率结果）
+    GLuint filteredDisplayTexture() const;
     void updateImageTextures();
-    void calculateImageStats(const std::vector<std::vector<double>>& image, ImageStats& stats);
+    static void calculateImageStats(const Image<double>& image, ImageStats& stats);
     void drawImageWithLegend(GLuint texture, int width, int height, 
                            const std::string& title, const ImageStats& stats);
     void drawFrequencyPlot();
-    void drawHistogram(const std::vector<std::vector<double>>& image, const std::string& title);
+    void drawHistogram(const Image<double>& image, const std::string& title);
     
     // GUI窗口绘制方法
     void drawMainMenuBar();
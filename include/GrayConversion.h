@@ -0,0 +1,37 @@
+#ifndef GRAY_CONVERSION_H
+#define GRAY_CONVERSION_H
+
+#include "Image.h"
+
+// 灰度转换方式
+enum class GrayMode {
+    Luma,        // 直接对 sRGB 编码值加权（0.299/0.587/0.114，与原实现逐位一致）
+    LinearLight  // 先按 sRGB 传递函数解码为线性光强，再按 Rec.709 权重（0.2126/0.7152/0.0722）加权
+};
+
+// 8 位交错像素 -> 双精度灰度
+// 每个通道的"解码 × 权重"预先算成 256 项的表，逐像素只需查表和两次加法，
+// 因此线性化模式与普通模式的开销相同。输出范围都是 [0, 255]。
+// 1 通道和 2 通道（灰度 + alpha）取第一个通道，3 通道和 4 通道（RGBA）忽略 alpha。
+// CPU 支持 AVX2 时按通道布局使用向量内核（gather 查表），否则使用标量内核。
+class GrayConverter {
+public:
+    explicit GrayConverter(GrayMode mode = GrayMode::Luma);
+
+    GrayMode mode() const { return grayMode; }
+
+    // 转换一行 width 个像素
+    void convertRow(const unsigned char* src, int width, int channels, double* dst) const;
+    // 转换整幅图像（行间无填充），各行并行；output 调整为 width × height
+    void convert(const unsigned char* src, int width, int height, int channels, Image<double>& output) const;
+
+    static const char* modeName(GrayMode mode);
+
+private:
+    GrayMode grayMode;
+    // weights[c][v]：第 c 个颜色通道取值 v 对灰度的贡献；single[v]：单通道图像取值 v 的灰度
+    alignas(64) double weights[3][256];
+    alignas(64) double single[256];
+};
+
+#endif // GRAY_CONVERSION_H
@@ -0,0 +1,188 @@
+#ifndef IMAGE_H
+#define IMAGE_H
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+// 二维图像/频谱容器
+// 整块连续内存、按行存储，首地址64字节对齐；每行长度按对齐要求补齐为stride个元素，
+// 因此每一行的起始地址同样是64字节对齐的，可直接交给向量化内核使用。
+// 也可以作为外部内存（如内存映射文件）上的视图，见 view()。
+template<typename T>
+class Image {
+    static_assert(std::is_trivially_copyable<T>::value, "Image<T> requires a trivially copyable element type");
+
+public:
+    static constexpr size_t Alignment = 64;
+
+    Image() : data_(nullptr), width_(0), height_(0), stride_(0), capacity_(0), owned_(false) {}
+
+    Image(int width, int height, const T& value = T())
+        : data_(nullptr), width_(0), height_(0), stride_(0), capacity_(0), owned_(false) {
+        resize(width, height, value);
+    }
+
+    Image(const Image& other)
+        : data_(nullptr), width_(0), height_(0), stride_(0), capacity_(0), owned_(false) {
+        copyFrom(other);
+    }
+
+    Image(Image&& other) noexcept
+        : data_(other.data_), width_(other.width_), height_(other.height_),
+          stride_(other.stride_), capacity_(other.capacity_), owned_(other.owned_) {
+        other.data_ = nullptr;
+        other.width_ = other.height_ = 0;
+        other.stride_ = other.capacity_ = 0;
+        other.owned_ = false;
+    }
+
+    // 外部内存上的视图：不拥有也不释放 data，调用者保证其在视图使用期间有效。
+    // stride 以元素计，data 与每行起始地址应64字节对齐；不超过 stride×height 的 resize
+    // 继续使用这块内存，更大的 resize 改为自行分配
+    static Image view(T* data, int width, int height, size_t stride) {
+        Image image;
+        image.data_ = data;
+        image.width_ = width;
+        image.height_ = height;
+        image.stride_ = stride;
+        image.capacity_ = stride * static_cast<size_t>(height);
+        return image;
+    }
+
+    ~Image() {
+        release();
+    }
+
+    Image& operator=(const Image& other) {
+        if (this != &other) {
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    Image& operator=(Image&& other) noexcept {
+        if (this != &other) {
+            release();
+            data_ = other.data_;
+            width_ = other.width_;
+            height_ = other.height_;
+            stride_ = other.stride_;
+            capacity_ = other.capacity_;
+            owned_ = other.owned_;
+            other.data_ = nullptr;
+            other.width_ = other.height_ = 0;
+            other.stride_ = other.capacity_ = 0;
+            other.owned_ = false;
+        }
+        return *this;
+    }
+
+    // 调整尺寸；已有容量足够时复用内存，不重新分配。内容未定义
+    void resize(int width, int height) {
+        if (width <= 0 || height <= 0) {
+            clear();
+            return;
+        }
+        size_t stride = alignedStride(width);
+        size_t required = stride * static_cast<size_t>(height);
+        if (required > capacity_) {
+            release();
+            data_ = static_cast<T*>(::operator new(required * sizeof(T), std::align_val_t(Alignment)));
+            capacity_ = required;
+            owned_ = true;
+        }
+        width_ = width;
+        height_ = height;
+        stride_ = stride;
+    }
+
+    // 调整尺寸并用value填充
+    void resize(int width, int height, const T& value) {
+        resize(width, height);
+        fill(value);
+    }
+
+    void fill(const T& value) {
+        for (int y = 0; y < height_; y++) {
+            std::fill(row(y), row(y) + width_, value);
+        }
+    }
+
+    // 清空尺寸但保留已分配的内存
+    void clear() {
+        width_ = height_ = 0;
+        stride_ = 0;
+    }
+
+    // 释放全部内存（视图只解除引用）
+    void release() {
+        if (data_ && owned_) {
+            ::operator delete(data_, std::align_val_t(Alignment));
+        }
+        data_ = nullptr;
+        width_ = height_ = 0;
+        stride_ = capacity_ = 0;
+        owned_ = false;
+    }
+
+    bool empty() const { return width_ == 0 || height_ == 0; }
+    int width() const { return width_; }
+    int height() const { return height_; }
+    size_t stride() const { return stride_; }              // 以元素计的行跨度
+    size_t size() const { return static_cast<size_t>(width_) * height_; }
+    size_t capacity() const { return capacity_; }
+    bool isView() const { return data_ != nullptr && !owned_; }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+
+    T* row(int y) { return data_ + static_cast<size_t>(y) * stride_; }
+    const T* row(int y) const { return data_ + static_cast<size_t>(y) * stride_; }
+
+    // img[y][x] 形式访问
+    T* operator[](int y) { return row(y); }
+    const T* operator[](int y) const { return row(y); }
+
+    T& operator()(int x, int y) { return row(y)[x]; }
+    const T& operator()(int x, int y) const { return row(y)[x]; }
+
+    // 每行按64字节补齐后的元素个数
+    static size_t alignedStride(int width) {
+        size_t w = static_cast<size_t>(width);
+        if (Alignment % sizeof(T) != 0) {
+            return w;
+        }
+        size_t perLine = Alignment / sizeof(T);
+        return (w + perLine - 1) / perLine * perLine;
+    }
+
+private:
+    T* data_;
+    int width_, height_;
+    size_t stride_;
+    size_t capacity_;
+    bool owned_;
+
+    void copyFrom(const Image& other) {
+        resize(other.width_, other.height_);
+        if (other.stride_ == stride_) {
+            if (!empty()) {
+                std::memcpy(data_, other.data_, stride_ * height_ * sizeof(T));
+            }
+            return;
+        }
+        for (int y = 0; y < height_; y++) {
+            std::memcpy(row(y), other.row(y), width_ * sizeof(T));
+        }
+    }
+};
+
+// 频谱与图像共用同一容器，元素类型为复数
+template<typename T>
+using Spectrum = Image<T>;
+
+#endif // IMAGE_H
@@ -3,11 +3,24 @@
 
 #include <vector>
 #include <string>
+#include <cstddef>
 #include "Complex.h"
+#include "Image.h"
+#include "FFT2D.h"
+#include "RadialFilter.h"
+#include "RadialBandCache.h"
+#include "FilterChain.h"
+#include "MappedFile.h"
+#include "GrayConversion.h"
+
+class RowDecoder;
 
 // 前向声明，避免在头文件中包含实现
 extern "C" {
     unsigned char *stbi_load(char const *filename, int *x, int *y, int *channels_in_file, int desired_channels);
+    unsigned char *stbi_load_from_memory(unsigned char const *buffer, int len, int *x, int *y, int *channels_in_file, int desired_channels);
+    int stbi_info(char const *filename, int *x, int *y, int *comp);
+    int stbi_info_from_memory(unsigned char const *buffer, int len, int *x, int *y, int *comp);
     void stbi_image_free(void *retval_from_stbi_load);
     char const *stbi_failure_reason(void);
     
@@ -17,31 +30,116 @@ extern "C" {
     int stbi_write_jpg(char const *filename, int w, int h, int comp, const void *data, int quality);
 }
 
+// FFT计算精度
+// Float 模式下变换以单精度执行（SIMD宽度加倍），结果仍以双精度频谱保存，滤波和显示代码不受影响。
+// 变换前后各多一次 double/float 转换，频谱和预览的内存占用与访存量不会减少
+enum class Precision {
+    Double,
+    Float
+};
+
+// 单精度与双精度FFT结果的对比
+struct PrecisionReport {
+    bool valid = false;
+    double spectrumMaxError = 0.0;    // 频谱最大绝对误差 / 频谱最大幅值
+    double spectrumRmsError = 0.0;    // 频谱均方根误差 / 频谱均方根幅值
+    double roundtripMaxError = 0.0;   // 单精度正逆变换后与原图的最大像素误差
+    double roundtripPSNR = 0.0;       // 单精度正逆变换结果的PSNR (dB)
+    double doubleTimeMs = 0.0;        // 双精度正逆变换耗时
+    double floatTimeMs = 0.0;         // 单精度正逆变换耗时
+};
+
+// 数值诊断信息（按需计算，不在变换路径中执行）
+struct NumericDiagnostics {
+    size_t count = 0;          // 元素总数
+    size_t nanCount = 0;       // NaN 个数
+    size_t infCount = 0;       // ±Inf 个数
+    double energy = 0.0;       // Σ|x|²（半频谱按共轭对称展开为完整频谱计算）
+    double minValue = 0.0;     // 实数图像：最小值；频谱：最小幅值
+    double maxValue = 0.0;     // 实数图像：最大值；频谱：最大幅值
+    double meanValue = 0.0;    // 实数图像：均值；频谱：平均幅值
+};
+
 class ImageProcessor {
 private:
-    std::vector<std::vector<double>> grayImage;
-    std::vector<std::vector<Complex>> frequencyDomain;
+    Image<double> grayImage;
+    Spectrum<Complex> frequencyDomain; // 半频谱：宽 W/2+1，自然顺序（直流在(0,0)）
     int width, height;
     int originalChannels; // 原始图像通道数
+    Precision precision;  // FFT计算精度
+    bool validation;      // 数值校验模式：变换前后各检查一次 NaN/Inf，并输出每次滤波的参数
+    GrayMode grayMode;    // 加载图像时的灰度转换方式
+    size_t memoryBudget;  // 内存预算（字节）
+    int tileSize;         // 分块滤波：每块的变换尺寸
+    int tileOverlap;      // 分块滤波：每块每侧与相邻块重叠的宽度
+    
+    // 工作区：容量只增不减，同一尺寸下重复滤波预览不再分配内存
+    Spectrum<Complex> inverseWork;      // 逆变换中列变换的中间结果
+    Spectrum<ComplexF> spectrumWorkF;   // 单精度路径的频谱
+    Spectrum<ComplexF> inverseWorkF;
+    Image<float> imageWorkF;            // 单精度路径的图像
+    Spectrum<Complex> previewSpectrum;  // 滤波预览：滤波后的半频谱
+    Image<double> previewImage;         // 滤波预览：重建图像
+    Spectrum<Complex> reducedSpectrum;  // 低分辨率预览：截取的低频系数
+    Spectrum<Complex> reducedFiltered;
+    Spectrum<Complex> reducedWork;
+    Image<double> reducedImage;
+    
+    // 平滑滤波的传递函数表，参数或尺寸变化时重建
+    RadialTransferLUT transferLUT;
+    FilterSpec transferSpec;
+    long long transferMaxSquared;
     
-    // 位反转函数
-    int bitReverse(int n, int bits);
+    // 径向频带分解缓存（可选），频谱变化时失效
+    RadialBandCache bandCache;
     
-    // 1D FFT/IFFT实现
-    void fft1D(std::vector<Complex>& data);
-    void ifft1D(std::vector<Complex>& data);
+    // 外存FFT：频谱超出内存预算时保存在映射的临时文件中，frequencyDomain 是其上的视图
+    MappedFile spectrumFile;
+    std::string scratchDirectory;
     
     // 辅助函数
     void rgbToGray(unsigned char* imageData, int w, int h, int channels);
+    // 逐行解码并直接转换为灰度图像
+    bool loadImageStreaming(RowDecoder& decoder, const std::string& filename);
     std::string openFileDialog();
-    bool isPowerOfTwo(int n);
-    void resizeImageToPowerOfTwo();
 
-    // FFT移位相关函数
-    std::vector<std::vector<Complex>> fftShift(const std::vector<std::vector<Complex>>& input);
-    std::vector<std::vector<Complex>> ifftShift(const std::vector<std::vector<Complex>>& input);
-
-    void analyzeFrequencySpectrum() const;
+    // 按当前精度执行的二维正逆变换
+    void forwardTransform(const Image<double>& input, Spectrum<Complex>& output);
+    // activeColumns 见 FFT2D::inverseC2R：kx >= activeColumns 的列已知为零，逆变换时跳过
+    void inverseTransform(const Spectrum<Complex>& input, Image<double>& output, int activeColumns = -1);
+    
+    // 把重建结果限制到 [0, 255] 并返回限幅前的值域；值域明显异常时返回 true，
+    // 调用者应重新计算原始结果后调用 renormalizeReconstruction 按值域线性映射
+    bool clampReconstruction(Image<double>& result, double& minVal, double& maxVal) const;
+    void renormalizeReconstruction(Image<double>& result, double minVal, double maxVal) const;
+    
+    // 截止比例对应的频率半径（以对角线长度的一半为基准）
+    double cutoffRadius(double cutoffRatio) const;
+    // 半径 radius 以内的频率在半频谱中占据的列数（kx <= radius）
+    int columnsWithinRadius(double radius) const;
+    // 取得与 spec 和当前尺寸对应的传递函数表
+    const RadialTransferLUT& transferTable(const FilterSpec& spec);
+    
+    // 所需内存超出预算时输出说明并返回 false
+    bool checkMemoryBudget(size_t bytes, const char* what) const;
+    // 外存变换每个条带可用的内存：预算中扣除常驻的灰度图像和结果图像
+    size_t outOfCoreWorkBytes() const;
+    // 丢弃频谱；外存频谱同时关闭其临时文件
+    void discardSpectrum();
+    // 分块滤波的一次完整计算，结果未限幅
+    void filterTilesRaw(const FilterSpec& spec, Image<double>& output);
+    // 分块滤波一个工作单元的缓冲区：块图像、滤波结果、块频谱和逆变换工作区
+    struct TileBuffers {
+        Image<double> block;
+        Image<double> filtered;
+        Spectrum<Complex> spectrum;
+        Spectrum<Complex> work;
+    };
+    // 滤波中心部分左上角为 (x0, y0) 的一块，中心部分写入 output
+    void filterTile(const RadialTransferLUT& lut, int x0, int y0, double scaleX, double scaleY,
+                    TileBuffers& buffer, Image<double>& output) const;
+    // 分块滤波的块数
+    size_t tileCount() const;
 
 public:
     // 构造函数
@@ -53,43 +151,125 @@ public:
     bool loadImageWithDialog(); // 弹出文件选择对话框
     void createTestImage(int size = 256); // 创建测试图像
     
-    // 2D FFT变换
+    // 2D FFT变换（实数到复数，结果为半频谱）
     void fft2D();
     
-    // 2D 逆FFT变换
-    std::vector<std::vector<double>> ifft2D(const std::vector<std::vector<Complex>>& freqData);
+    // 2D 逆FFT变换（输入为半频谱）
+    Image<double> ifft2D(const Spectrum<Complex>& freqData);
+    // 同上，结果写入 result（复用其内存）；activeColumns 见 inverseTransform
+    void ifft2D(const Spectrum<Complex>& freqData, Image<double>& result, int activeColumns = -1);
+    
+    // 滤波器（输入输出均为半频谱）
+    Spectrum<Complex> lowPassFilter(double cutoffRatio);
+    Spectrum<Complex> highPassFilter(double cutoffRatio);
+    Spectrum<Complex> bandPassFilter(double lowCutoff, double highCutoff);
+    Spectrum<Complex> lowPassFilterCentered(double cutoffRatio);
+    // 同上，结果写入 output（复用其内存）
+    void lowPassFilter(double cutoffRatio, Spectrum<Complex>& output);
+    void highPassFilter(double cutoffRatio, Spectrum<Complex>& output);
+    void bandPassFilter(double lowCutoff, double highCutoff, Spectrum<Complex>& output);
+    // 通用滤波：理想滤波按行整段选择，高斯/巴特沃斯/升余弦按查找表逐系数相乘
+    void applyFilter(const FilterSpec& spec, Spectrum<Complex>& output);
+    // 滤波链：一次遍历应用链中全部阶段；返回 output 中可能非零的列数（见 inverseTransform）
+    int applyFilterChain(FilterChain& chain, Spectrum<Complex>& output);
+    
+    // 滤波预览：在内部工作区中滤波并重建图像，不分配新内存；
+    // 返回的图像在下一次预览或重新加载图像前有效。全图变换超出内存预算时改用分块滤波
+    // （filterChainPreview 不支持，返回空图像），不分配全尺寸的预览频谱
+    const Image<double>& lowPassPreview(double cutoffRatio);
+    const Image<double>& highPassPreview(double cutoffRatio);
+    const Image<double>& bandPassPreview(double lowCutoff, double highCutoff);
+    const Image<double>& unfilteredPreview();
+    const Image<double>& filterPreview(const FilterSpec& spec);
+    const Image<double>& filterChainPreview(FilterChain& chain);
+    // 低分辨率预览：只取频谱中心的低频部分，在较长边不超过 maxSize 的网格上滤波并逆变换，
+    // 得到按比例缩小的滤波结果。缩小后频率下标的含义不变（每幅图像的周期数），
+    // 滤波链按原图的截止半径应用即可；返回的图像在下一次低分辨率预览前有效
+    const Image<double>& reducedPreview(FilterChain& chain, int maxSize);
+    
+    // 径向频带分解缓存：预先计算 bands 个环带的空间域图像，之后的预览只做加权求和
+    bool buildBandCache(int bands);
+    void clearBandCache() { bandCache.clear(); }
+    bool hasBandCache() const { return !bandCache.empty(); }
+    int getBandCount() const { return bandCache.bands(); }
+    size_t getBandCacheBytes() const { return bandCache.memoryBytes(); }
+    // 由频带缓存合成的近似预览（没有缓存时退回 filterPreview）
+    const Image<double>& bandCachePreview(const FilterSpec& spec);
+    
+    // 分块滤波：把图像分成相互重叠的块，各块独立做 FFT、滤波和逆变换，只保留每块的中心部分。
+    // 不需要全图频谱，额外内存只有输出图像和每个线程的块缓冲区；传递函数按原图的频率坐标
+    // 换算到块上，块边界处用镜像填充。空间核超出重叠宽度的滤波（如截止频率很低的理想滤波）
+    // 在块边界处是近似的
+    bool filterTiled(const FilterSpec& spec, Image<double>& output);
+    // size 为每块的变换尺寸，overlap 为每侧的重叠宽度（要求 size > 2 * overlap）
+    void setTileSize(int size, int overlap);
+    int getTileSize() const { return tileSize; }
+    int getTileOverlap() const { return tileOverlap; }
     
-    // 滤波器
-    std::vector<std::vector<Complex>> lowPassFilter(double cutoffRatio);
-    std::vector<std::vector<Complex>> highPassFilter(double cutoffRatio);
-    std::vector<std::vector<Complex>> bandPassFilter(double lowCutoff, double highCutoff);
-    std::vector<std::vector<Complex>> lowPassFilterCentered(double cutoffRatio);
+    // 内存预算：加载图像和频带缓存在分配前按预算检查，超出时给出明确的错误，不会缩小图像；
+    // 全图FFT超出预算时 fft2D/ifft2D 自动改用外存变换（OutOfCoreFFT），滤波预览可以使用分块滤波
+    static constexpr size_t DefaultMemoryBudget = sizeof(size_t) >= 8 ? (size_t(8) << 30) : (size_t(1) << 30);
+    void setMemoryBudget(size_t bytes) { memoryBudget = bytes; }
+    size_t getMemoryBudget() const { return memoryBudget; }
+    // 全图变换（含滤波预览工作区）所需的内存
+    size_t estimateTransformBytes(int w, int h) const;
+    // 当前图像的全图变换是否在预算之内
+    bool fitsFullTransform() const { return width > 0 && estimateTransformBytes(width, height) <= memoryBudget; }
+    // 当前频谱是否保存在外存临时文件中
+    bool isSpectrumOutOfCore() const { return spectrumFile.isOpen(); }
+    // 外存变换的临时文件目录，默认为 MappedFile::defaultScratchDirectory()
+    void setScratchDirectory(const std::string& directory) { scratchDirectory = directory; }
+    const std::string& getScratchDirectory() const { return scratchDirectory; }
     
     // 性能指标计算
-    double calculateMSE(const std::vector<std::vector<double>>& img1,
-                       const std::vector<std::vector<double>>& img2);
+    double calculateMSE(const Image<double>& img1, const Image<double>& img2);
     double calculatePSNR(double mse);
-    double calculateSSIM(const std::vector<std::vector<double>>& img1,
-                        const std::vector<std::vector<double>>& img2);
+    double calculateSSIM(const Image<double>& img1, const Image<double>& img2);
     
     // 3D可视化数据生成
     std::vector<float> getFrequencyVisualizationData();
     
     // 图像保存
-    bool saveImage(const std::string& filename, const std::vector<std::vector<double>>& image);
+    bool saveImage(const std::string& filename, const Image<double>& image);
     
     // Getter方法
-    const std::vector<std::vector<double>>& getGrayImage() const { return grayImage; }
-    const std::vector<std::vector<Complex>>& getFrequencyDomain() const { return frequencyDomain; }
+    const Image<double>& getGrayImage() const { return grayImage; }
+    const Spectrum<Complex>& getFrequencyDomain() const { return frequencyDomain; }
+    // 中心化（fftShift 后）的完整频谱视图，直接读取半频谱，不分配内存
+    FFT2D::CenteredSpectrumView<double> getCenteredView() const;
+    Complex getCenteredCoefficient(int x, int y) const;
     int getWidth() const { return width; }
     int getHeight() const { return height; }
     int getOriginalChannels() const { return originalChannels; }
     
+    // FFT计算精度
+    void setPrecision(Precision p) { precision = p; }
+    Precision getPrecision() const { return precision; }
+    // 在当前图像上分别以单、双精度执行正逆变换并比较结果
+    PrecisionReport comparePrecision() const;
+    
+    // 灰度转换方式，在下一次 loadImage 时生效（默认 Luma，与原始编码值加权）
+    void setGrayMode(GrayMode mode) { grayMode = mode; }
+    GrayMode getGrayMode() const { return grayMode; }
+    
+    // 数值校验模式（Release 默认关闭，Debug 默认开启）
+    void setValidationEnabled(bool enabled) { validation = enabled; }
+    bool isValidationEnabled() const { return validation; }
+    
+    // 数值诊断：统计 NaN/Inf 个数、能量和值域
+    NumericDiagnostics diagnoseImage(const Image<double>& image) const;
+    NumericDiagnostics diagnoseSpectrum(const Spectrum<Complex>& spectrum) const;
+    
+    // FFT并行线程数（<= 0 表示使用全部硬件线程）
+    void setThreadCount(int count);
+    int getThreadCount() const;
+    
     // 信息输出
     void printImageInfo() const;
 
-    // 调试和分析方法
+    // 调试和分析方法（输出到控制台）
     void analyzeFrequencyDomain() const;
+    void analyzeFrequencySpectrum() const;
 };
 
 #endif // IMAGE_PROCESSOR_H
\ No newline at end of file
@@ -0,0 +1,60 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+
+// 内存映射文件
+// 两种用法：
+// - 外存FFT的临时文件：在指定目录中创建后立即删除（Windows 上为关闭时删除），
+//   只通过映射访问，解除映射或进程退出时磁盘空间自动回收。
+// - 只读打开已有文件（加载图像）：解码器直接读取映射的内容，省去 read 系统调用和到用户缓冲区的复制。
+//   映射期间文件被其他进程截断时，访问越界的页面会收到 SIGBUS（Windows 上为访问异常）。
+// 映射的页面由内核按需读入、写回和回收，常驻内存不受文件大小限制。
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // 在 directory 中创建大小为 bytes 的临时文件并以读写方式映射；失败时输出原因并返回 false
+    bool createScratch(const std::string& directory, size_t bytes);
+    // 以只读方式映射已有的文件（不能写入映射的内容）。文件为空、不是普通文件或无法映射时返回 false，
+    // 不输出信息（调用者通常改用普通读取），原因由 failureReason() 给出
+    bool openReadOnly(const std::string& path);
+    // 解除映射并关闭文件
+    void close();
+
+    bool isOpen() const { return address != nullptr; }
+    void* data() { return address; }
+    const void* data() const { return address; }
+    size_t size() const { return length; }
+
+    // 提示内核 [offset, offset + bytes) 将按顺序访问，加大预读
+    void adviseSequential(size_t offset, size_t bytes);
+    // [offset, offset + bytes) 的内容不再读取，可以立即回收其页面（内容保留在文件中）
+    void release(size_t offset, size_t bytes);
+
+    // 最近一次 openReadOnly 失败的原因
+    const std::string& failureReason() const { return reason; }
+
+    // 默认的临时文件目录：TMPDIR（Windows 为 TEMP），未设置时为系统临时目录
+    static std::string defaultScratchDirectory();
+
+private:
+    void* address = nullptr;
+    size_t length = 0;
+    std::string reason;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int descriptor = -1;
+#endif
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,31 @@
+#ifndef OUT_OF_CORE_FFT_H
+#define OUT_OF_CORE_FFT_H
+
+#include <string>
+#include <cstddef>
+#include "Complex.h"
+#include "Image.h"
+#include "MappedFile.h"
+
+// 外存二维实数FFT
+// 频谱超出内存预算时使用：半频谱和中间结果保存在内存映射的临时文件（MappedFile）中，按
+//   行变换（按行条带）-> 转置写入临时文件 -> 列变换（临时文件的每一行是频谱的一列）-> 转置写回
+// 的顺序执行。每一步只处理一个条带，常驻内存约为 workBytes；对临时文件的读写都是整段的顺序访问，
+// 转置时每次写入一个条带宽度的连续数据。结果与 FFT2D 的内存版本逐位一致（使用相同的一维计划和行变换）。
+// 只提供双精度。
+namespace OutOfCoreFFT {
+    // 实数图像 -> 半频谱。结果保存在 spectrumFile 中，spectrum 为其上的视图（宽 W/2+1、自然顺序，
+    // 与 FFT2D::forwardR2C 相同），spectrumFile 关闭之前视图有效。失败时输出原因并返回 false
+    bool forwardR2C(const Image<double>& input, const std::string& scratchDirectory, size_t workBytes,
+                    MappedFile& spectrumFile, Spectrum<Complex>& spectrum);
+
+    // 半频谱 -> 实数图像（含 1/(W*H) 归一化）。input 可以在内存中，也可以是映射文件上的视图；
+    // width 和 activeColumns 的含义见 FFT2D::inverseC2R
+    bool inverseC2R(const Spectrum<Complex>& input, int width, const std::string& scratchDirectory,
+                    size_t workBytes, Image<double>& output, int activeColumns = -1);
+
+    // 正变换需要的临时文件总大小（频谱与转置中间结果），用于检查磁盘空间
+    size_t scratchBytes(int width, int height);
+}
+
+#endif // OUT_OF_CORE_FFT_H
@@ -0,0 +1,100 @@
+#ifndef PREVIEW_WORKER_H
+#define PREVIEW_WORKER_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+#include "Image.h"
+
+// 图像统计与质量指标
+struct ImageStats {
+    double mse;
+    double psnr;
+    double ssim;
+    double meanValue;
+    double stdValue;
+    double minValue;
+    double maxValue;
+};
+
+// 一次预览的结果：重建图像、上传纹理用的 RGBA 数据和统计信息
+struct PreviewResult {
+    Image<double> image;
+    std::vector<unsigned char> rgba;
+    ImageStats stats{};
+    int level = 0;   // 逐级细化的级别：0 为原始分辨率，k > 0 为从粗到细的第 k 级低分辨率结果
+};
+
+// 后台预览线程
+// 只保留最新提交的任务：尚未开始的旧任务直接被替换（合并），正在运行的旧任务在下一个
+// 检查点处放弃（取消）。结果三缓冲：工作线程写 working，完成后与 completed 交换；
+// GUI 线程每帧调用 poll()，有新结果时与 front 交换。在此之前 front 保持上一次完成的结果，
+// 稳定状态下各缓冲区的内存都被复用。
+// 任务与 GUI 线程共享 ImageProcessor 的预览工作区，GUI 线程在修改处理器之前必须调用 cancelAndWait()。
+class PreviewWorker {
+public:
+    // 任务与工作线程之间的联系
+    class Token {
+    public:
+        // 提交了更新的任务或调用了 cancelAndWait() 之后返回 true
+        bool cancelled() const { return owner->latest.load(std::memory_order_relaxed) != generation; }
+        // 把 result 中已写好的中间结果（如低分辨率预览）交给 GUI 线程；
+        // 之后 result 换成另一块缓冲区，任务需要重新写入全部字段
+        void publish() const;
+
+    private:
+        friend class PreviewWorker;
+        Token(PreviewWorker* owner, uint64_t generation) : owner(owner), generation(generation) {}
+
+        PreviewWorker* owner;
+        uint64_t generation;
+    };
+
+    // 在工作线程中执行，把结果写入 result；应在各阶段之间检查 token，
+    // 返回 false 表示已放弃，结果不会被显示
+    using Job = std::function<bool(PreviewResult& result, const Token& token)>;
+
+    PreviewWorker();
+    ~PreviewWorker();
+
+    PreviewWorker(const PreviewWorker&) = delete;
+    PreviewWorker& operator=(const PreviewWorker&) = delete;
+
+    // 提交任务，替换尚未开始的任务并取消正在运行的任务
+    void submit(Job job);
+    // 丢弃全部任务和未取走的结果，等待工作线程空闲
+    void cancelAndWait();
+    // 等待已提交的任务全部完成（结果保留）
+    void waitIdle();
+    // 是否有任务正在运行或等待运行
+    bool busy() const;
+
+    // GUI 线程：有新完成的结果时换到前台并返回 true
+    bool poll();
+    // 最近一次 poll() 取到的结果
+    const PreviewResult& result() const { return front; }
+
+private:
+    void workerLoop();
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    Job pending;
+    bool running = false;
+    bool ready = false;
+    bool stopping = false;
+    std::atomic<uint64_t> latest{0};
+
+    PreviewResult working;     // 只由工作线程访问
+    PreviewResult completed;   // 已完成、尚未取走
+    PreviewResult front;       // 只由 GUI 线程访问
+
+    std::thread thread;
+};
+
+#endif // PREVIEW_WORKER_H
@@ -0,0 +1,48 @@
+#ifndef RADIAL_BAND_CACHE_H
+#define RADIAL_BAND_CACHE_H
+
+#include <vector>
+#include <cstddef>
+#include "Complex.h"
+#include "Image.h"
+#include "RadialFilter.h"
+
+// 径向频带分解缓存
+// 把半频谱按半径等分为 K 个环带（截止比例 k/K 处分界），分别逆变换后以单精度保存；
+// 直流分量单独作为一项（逆变换是常数，只保存其数值），高通滤波去除直流时不受环带近似影响。
+// 逆变换是线性的，任意径向滤波的结果都可以近似为这 K 幅空间域图像的加权和，
+// 权重为传递函数在该环带上的面积加权平均。
+// 截止频率恰好落在环带分界上的理想滤波结果是精确的（分界圆上恰好有系数时，
+// 高通/带通内侧边界的归属与逐系数滤波不同），其余情况是按环带分段常数的近似。
+// 构建需要 K 次逆变换（各环带并行），之后每次预览只需 O(K·N) 的乘加。
+class RadialBandCache {
+public:
+    // 环带数上限（compose 的权重放在栈上）
+    static constexpr int MaxBands = 64;
+
+    // 由半频谱构建 bands 个环带图像（不超过 MaxBands）；width 为原图宽度，radiusScale 为截止比例 1 对应的半径
+    void build(const Spectrum<Complex>& spectrum, int width, int bands, double radiusScale);
+    // 释放全部环带图像
+    void clear();
+
+    bool empty() const { return images.empty(); }
+    int bands() const { return static_cast<int>(images.size()); }
+    size_t memoryBytes() const;
+    // 以指定尺寸和环带数构建时需要的内存
+    static size_t estimateBytes(int width, int height, int bands);
+    // 构建过程中另外需要的临时内存：threads 个并行任务各自的环带频谱、逆变换工作区和双精度图像
+    static size_t buildWorkBytes(int width, int height, int bands, int threads);
+
+    // 按 spec 的传递函数计算各环带权重，加权求和写入 output（未限幅）。
+    // 只读取缓存，可以在多个线程上同时调用
+    void compose(const FilterSpec& spec, Image<double>& output) const;
+
+private:
+    std::vector<Image<float>> images;   // 各环带的空间域图像
+    double dcLevel = 0.0;               // 直流分量逆变换后的常数值
+    double scale = 1.0;
+    int width = 0;
+    int height = 0;
+};
+
+#endif // RADIAL_BAND_CACHE_H
@@ -0,0 +1,89 @@
+#ifndef RADIAL_FILTER_H
+#define RADIAL_FILTER_H
+
+#include <vector>
+#include <cstddef>
+
+// 径向频域滤波器的描述与传递函数查找表
+
+// 传递函数形状
+enum class FilterShape {
+    Ideal,         // 理想（砖墙）滤波，按行整段选择
+    Gaussian,      // 高斯：exp(-d²/2D²)
+    Butterworth,   // 巴特沃斯：1/(1+(d/D)^2n)
+    RaisedCosine   // 升余弦：在 [D(1-β), D(1+β)] 内由 1 平滑过渡到 0
+};
+
+// 频带类型
+enum class FilterBand {
+    LowPass,
+    HighPass,
+    BandPass
+};
+
+// 滤波参数：截止频率均为比例，由 ImageProcessor 换算为半径（以对角线长度的一半为基准）
+struct FilterSpec {
+    FilterShape shape = FilterShape::Ideal;
+    FilterBand band = FilterBand::LowPass;
+    double cutoff = 0.5;     // 低通/高通的截止比例
+    double bandLow = 0.2;    // 带通的下限比例
+    double bandHigh = 0.8;   // 带通的上限比例
+    int order = 2;           // 巴特沃斯阶数
+    double rolloff = 0.5;    // 升余弦过渡带宽 β（相对截止半径）
+
+    bool operator==(const FilterSpec& other) const {
+        return shape == other.shape && band == other.band && cutoff == other.cutoff &&
+               bandLow == other.bandLow && bandHigh == other.bandHigh &&
+               order == other.order && rolloff == other.rolloff;
+    }
+    bool operator!=(const FilterSpec& other) const { return !(*this == other); }
+};
+
+// 以平方半径 d² 为下标的传递函数表
+// 半频谱上 d² = kx² + dy² 是整数：d² < ExactSize 的部分逐个整数存一项（覆盖半径约 181 以内，
+// 截止半径较小时过渡带也能精确表示）；更大的 d² 按均匀步长量化，查表时线性插值。
+// 表长与图像尺寸无关（最多 ExactSize + CoarseSize 项），每次参数变化只需重算这些项，
+// 逐系数的滤波只剩一次查表和一次乘法，不再调用 exp/pow/cos。
+class RadialTransferLUT {
+public:
+    static constexpr int ExactSize = 32768;
+    static constexpr int CoarseSize = 32768;
+    // 低通尾部小于该值的项置为零，以便逆变换跳过全零的列
+    static constexpr double TailEpsilon = 1e-9;
+
+    // radiusScale：截止比例 1 对应的半径；maxSquared：需要覆盖的最大 d²
+    void build(const FilterSpec& spec, double radiusScale, long long maxSquared);
+
+    double operator()(long long squared) const {
+        if (squared < static_cast<long long>(exact.size())) {
+            return exact[static_cast<size_t>(squared)];
+        }
+        // 没有量化部分时表只覆盖到 maxSquared < ExactSize，更大的 d² 取最后一项
+        if (coarse.empty()) {
+            return exact.back();
+        }
+        // 此时 exact 恰好有 ExactSize 项，squared >= ExactSize
+        double position = static_cast<double>(squared - ExactSize) * inverseStep;
+        size_t index = static_cast<size_t>(position);
+        if (index + 1 >= coarse.size()) {
+            return coarse.back();
+        }
+        double t = position - static_cast<double>(index);
+        return coarse[index] + (coarse[index + 1] - coarse[index]) * t;
+    }
+
+    // 传递函数可能非零的最大 d²；-1 表示全部为零
+    long long supportSquared() const { return support; }
+
+    // 单点求值（建表时使用，d 为半径）
+    static double evaluate(const FilterSpec& spec, double radiusScale, double d);
+
+private:
+    std::vector<double> exact;
+    std::vector<double> coarse;
+    double step = 1.0;
+    double inverseStep = 1.0;
+    long long support = -1;
+};
+
+#endif // RADIAL_FILTER_H
@@ -0,0 +1,52 @@
+#ifndef ROW_DECODER_H
+#define ROW_DECODER_H
+
+#include <string>
+#include <memory>
+#include <cstddef>
+
+// 逐行图像解码器
+// 按文件中的存储顺序一次解码一行，输出每通道 8 位、通道交错的像素（RGB 顺序，与 stb_image 相同），
+// 解码过程中只保留一两行的缓冲区，调用者可以直接把每一行转换到最终的目标缓冲区中。
+// 支持：PNM（P5/P6，8/16 位）、BMP（1/4/8 位调色板、24/32 位，未压缩）、
+// TGA（8 位灰度、24/32 位真彩色、8 位调色板，含 RLE）、PNG（非隔行，需要 zlib，定义 HAS_ZLIB）。
+// 其他格式或变体由 open() 返回空指针，调用者改用 stb_image 整体解码。
+class RowDecoder {
+public:
+    virtual ~RowDecoder() = default;
+
+    // 按文件内容（PNG/BMP/PNM 的文件头，TGA 的扩展名）选择解码器；不支持时返回 nullptr
+    static std::unique_ptr<RowDecoder> open(const std::string& filename);
+    // 从内存中的文件内容（通常是只读映射的文件）解码，像素数据直接从 data 中读取而不经过读缓冲区。
+    // data 在解码器使用期间必须保持有效；filename 只用于识别 TGA 扩展名
+    static std::unique_ptr<RowDecoder> open(const unsigned char* data, size_t size, const std::string& filename);
+
+    int width() const { return imageWidth; }
+    int height() const { return imageHeight; }
+    // 输出的通道数，与 stb_image 报告的原始通道数一致
+    int channels() const { return imageChannels; }
+
+    // 解码下一行到 row（width() * channels() 字节），y 为该行在图像中自上而下的行号
+    // （BMP 和 TGA 通常自下而上存储）。数据损坏或提前结束时返回 false
+    virtual bool nextRow(unsigned char* row, int& y) = 0;
+    // 与 nextRow 相同，但返回这一行数据的地址：文件中的数据已经是输出格式时（8 位 PGM/PPM）
+    // 直接指向读取到的数据而不复制到 row，否则解码到 row 并返回 row。失败时返回 nullptr。
+    // 返回的地址只在下一次解码之前有效
+    virtual const unsigned char* nextRowData(unsigned char* row, int& y);
+
+    // 最近一次失败的原因
+    const char* failureReason() const { return reason; }
+
+protected:
+    bool fail(const char* message) {
+        reason = message;
+        return false;
+    }
+
+    int imageWidth = 0;
+    int imageHeight = 0;
+    int imageChannels = 0;
+    const char* reason = "";
+};
+
+#endif // ROW_DECODER_H
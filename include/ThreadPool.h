@@ -0,0 +1,96 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <cstdint>
+
+// 固定大小的线程池，只提供数据并行的 parallelFor
+// 调用线程本身也参与计算，因此 threadCount() = 工作线程数 + 1。
+// 同一时刻只执行一个 parallelFor；在任务内部再次调用 parallelFor 会直接串行执行。
+class ThreadPool {
+public:
+    // threadCount <= 0 时使用硬件线程数
+    explicit ThreadPool(int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int threadCount() const { return static_cast<int>(workers.size()) + 1; }
+    // 重新创建工作线程（不能在 parallelFor 的任务内部调用）
+    void setThreadCount(int count);
+
+    // 将 [begin, end) 按 grain 大小分块，由各线程调用 body(blockBegin, blockEnd)
+    // grain <= 0 时按线程数自动选择块大小；任务抛出的第一个异常会在调用线程重新抛出。
+    // body 只以指针形式传给工作线程，提交任务不分配内存
+    template<typename Body>
+    void parallelFor(int begin, int end, int grain, const Body& body) {
+        run(begin, end, grain, Task{&invokeBody<Body>, &body});
+    }
+
+    // 在每个线程（各工作线程和调用线程）上各调用一次 body()，用于预先建立线程局部的缓冲区：
+    // parallelFor 动态分配任务块，某个线程是否拿到过任务不确定
+    template<typename Body>
+    void forEachThread(const Body& body) {
+        broadcast(Task{&invokeOnce<Body>, &body});
+    }
+
+    // 全局线程池（FFT等计算共享）
+    static ThreadPool& global();
+    static int hardwareThreads();
+
+private:
+    // 类型擦除的任务引用（不持有 body，只在 parallelFor 返回前有效）
+    struct Task {
+        void (*invoke)(const void* context, int begin, int end);
+        const void* context;
+
+        void operator()(int begin, int end) const { invoke(context, begin, end); }
+    };
+
+    template<typename Body>
+    static void invokeBody(const void* context, int begin, int end) {
+        (*static_cast<const Body*>(context))(begin, end);
+    }
+
+    template<typename Body>
+    static void invokeOnce(const void* context, int, int) {
+        (*static_cast<const Body*>(context))();
+    }
+
+    void run(int begin, int end, int grain, const Task& task);
+    void broadcast(const Task& task);
+    void submit(const Task& task, bool everyThread);
+    void finish();
+    void start(int count);
+    void stop();
+    void workerLoop(uint64_t seen);
+    void runChunks();
+    void runOnce();
+
+    std::vector<std::thread> workers;
+
+    std::mutex submitMutex;         // 串行化 parallelFor 调用
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    uint64_t generation = 0;
+    int busyWorkers = 0;
+    bool stopping = false;
+
+    // 当前任务
+    Task task{nullptr, nullptr};
+    int jobBegin = 0;
+    int jobEnd = 0;
+    int jobGrain = 1;
+    bool everyThread = false;       // 当前任务由每个线程各执行一次（forEachThread）
+    std::atomic<int> nextChunk{0};
+    std::exception_ptr firstError;
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,277 @@
+#include "FFT2D.h"
+#include "FFTPlan.h"
+#include "ThreadPool.h"
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// 列变换分块：每次从每行连续读取若干个复数，转置到连续的列缓冲区中再做一维FFT，
+// 避免逐元素跨行访问。块宽度随列高调整，使块缓冲区留在 L2 中，
+// 同时每行至少读取一整条缓存行（64 字节）
+constexpr size_t ColumnTileBudget = 512 * 1024;
+constexpr int MaxColumnBlock = 16;
+
+template<typename T>
+int columnBlockWidth(int height) {
+    constexpr int minWidth = static_cast<int>(64 / sizeof(ComplexT<T>));
+    size_t columnBytes = static_cast<size_t>(height) * sizeof(ComplexT<T>);
+    int fit = static_cast<int>(std::min<size_t>(ColumnTileBudget / columnBytes, MaxColumnBlock));
+    return std::max(fit, minWidth);
+}
+
+// 行缓冲区和列块缓冲区：每个线程各一份，容量只增不减，稳定后变换过程不再分配内存
+enum ScratchSlot {
+    RowScratch,
+    TileScratch
+};
+
+template<typename T, int Slot>
+ComplexT<T>* scratchBuffer(size_t size) {
+    thread_local std::vector<ComplexT<T>> scratch;
+    if (scratch.size() < size) {
+        scratch.resize(size);
+    }
+    return scratch.data();
+}
+
+// 对 [xBegin, xEnd) 范围的列做一维FFT：从 src 读取，结果写入 dst（可以是同一个频谱），
+// tile 为调用者提供的临时缓冲区（至少 blockWidth * height 个元素）
+template<typename T>
+void transformColumns(const Spectrum<ComplexT<T>>& src, Spectrum<ComplexT<T>>& dst,
+                      const FFTPlanT<T>& plan, bool inverse, int blockWidth,
+                      int xBegin, int xEnd, ComplexT<T>* tile) {
+    int height = src.height();
+
+    for (int x0 = xBegin; x0 < xEnd; x0 += blockWidth) {
+        int count = std::min(blockWidth, xEnd - x0);
+
+        // 分块转置：行主序 -> 每列连续
+        for (int y = 0; y < height; y++) {
+            const ComplexT<T>* in = src.row(y) + x0;
+            for (int b = 0; b < count; b++) {
+                tile[static_cast<size_t>(b) * height + y] = in[b];
+            }
+        }
+
+        for (int b = 0; b < count; b++) {
+            ComplexT<T>* column = tile + static_cast<size_t>(b) * height;
+            if (inverse) {
+                plan.inverse(column);
+            } else {
+                plan.forward(column);
+            }
+        }
+
+        // 转置写回
+        for (int y = 0; y < height; y++) {
+            ComplexT<T>* out = dst.row(y) + x0;
+            for (int b = 0; b < count; b++) {
+                out[b] = tile[static_cast<size_t>(b) * height + y];
+            }
+        }
+    }
+}
+
+// 按列块并行执行前 columns 列的变换，保证每个任务拿到完整的列块
+template<typename T>
+void transformColumnsParallel(const Spectrum<ComplexT<T>>& src, Spectrum<ComplexT<T>>& dst,
+                              const FFTPlanT<T>& plan, bool inverse, int columns) {
+    int blockWidth = columnBlockWidth<T>(src.height());
+    int blocks = (columns + blockWidth - 1) / blockWidth;
+    ThreadPool::global().parallelFor(0, blocks, 0, [&](int blockBegin, int blockEnd) {
+        ComplexT<T>* tile = scratchBuffer<T, TileScratch>(static_cast<size_t>(blockWidth) * src.height());
+        int xBegin = blockBegin * blockWidth;
+        int xEnd = std::min(blockEnd * blockWidth, columns);
+        transformColumns(src, dst, plan, inverse, blockWidth, xBegin, xEnd, tile);
+    });
+}
+
+}
+
+namespace FFT2D {
+
+template<typename T>
+void forwardRows(const Image<T>& input, int yBegin, int yEnd, Spectrum<ComplexT<T>>& output) {
+    int width = input.width();
+    int half = halfWidth(width);
+    int rows = yEnd - yBegin;
+    auto rowPlan = FFTPlanT<T>::get(width);
+
+    // 两行实数据打包成 z = a + i·b，一次复数FFT得到两行的频谱
+    // 各行对互不相关，按行对分块并行
+    ThreadPool::global().parallelFor(0, (rows + 1) / 2, 0, [&](int pairBegin, int pairEnd) {
+        ComplexT<T>* buffer = scratchBuffer<T, RowScratch>(width);
+        for (int r = 2 * pairBegin; r < 2 * pairEnd && r < rows; r += 2) {
+            const T* a = input.row(yBegin + r);
+            const T* b = (r + 1 < rows) ? input.row(yBegin + r + 1) : nullptr;
+            for (int x = 0; x < width; x++) {
+                buffer[x] = ComplexT<T>(a[x], b ? b[x] : T(0));
+            }
+
+            rowPlan->forward(buffer);
+
+            // A[k] = (Z[k] + conj(Z[N-k])) / 2,  B[k] = (Z[k] - conj(Z[N-k])) / 2i
+            ComplexT<T>* outA = output.row(r);
+            ComplexT<T>* outB = b ? output.row(r + 1) : nullptr;
+            for (int k = 0; k < half; k++) {
+                const ComplexT<T>& zk = buffer[k];
+                const ComplexT<T>& zn = buffer[(width - k) % width];
+                outA[k] = ComplexT<T>(T(0.5) * (zk.real + zn.real), T(0.5) * (zk.imag - zn.imag));
+                if (outB) {
+                    outB[k] = ComplexT<T>(T(0.5) * (zk.imag + zn.imag), -T(0.5) * (zk.real - zn.real));
+                }
+            }
+        }
+    });
+}
+
+template<typename T>
+void inverseRows(const Spectrum<ComplexT<T>>& input, int width, int activeColumns, Image<T>& output, int yBegin) {
+    int rows = input.height();
+    int half = input.width();
+    auto rowPlan = FFTPlanT<T>::get(width);
+
+    // 两行半频谱 A、B 组合为 Z = A + i·B，由共轭对称补全另一半
+    ThreadPool::global().parallelFor(0, (rows + 1) / 2, 0, [&](int pairBegin, int pairEnd) {
+        ComplexT<T>* buffer = scratchBuffer<T, RowScratch>(width);
+        for (int r = 2 * pairBegin; r < 2 * pairEnd && r < rows; r += 2) {
+            const ComplexT<T>* a = input.row(r);
+            const ComplexT<T>* b = (r + 1 < rows) ? input.row(r + 1) : nullptr;
+            for (int k = 0; k < activeColumns; k++) {
+                ComplexT<T> bk = b ? b[k] : ComplexT<T>();
+                buffer[k] = ComplexT<T>(a[k].real - bk.imag, a[k].imag + bk.real);
+            }
+            for (int k = activeColumns; k <= std::min(width - activeColumns, width - 1); k++) {
+                buffer[k] = ComplexT<T>();
+            }
+            for (int k = std::max(half, width - activeColumns + 1); k < width; k++) {
+                int m = width - k;
+                ComplexT<T> bm = b ? b[m] : ComplexT<T>();
+                buffer[k] = ComplexT<T>(a[m].real + bm.imag, bm.real - a[m].imag);
+            }
+            // 直流和奈奎斯特分量在实数信号中必为实数，丢弃其虚部避免串到另一行
+            if (activeColumns > 0) {
+                buffer[0] = ComplexT<T>(a[0].real, b ? b[0].real : T(0));
+            }
+            if (width % 2 == 0 && width > 1 && width / 2 < activeColumns) {
+                int nyquist = width / 2;
+                buffer[nyquist] = ComplexT<T>(a[nyquist].real, b ? b[nyquist].real : T(0));
+            }
+
+            rowPlan->inverse(buffer);
+
+            T* outA = output.row(yBegin + r);
+            for (int x = 0; x < width; x++) {
+                outA[x] = buffer[x].real;
+            }
+            if (b) {
+                T* outB = output.row(yBegin + r + 1);
+                for (int x = 0; x < width; x++) {
+                    outB[x] = buffer[x].imag;
+                }
+            }
+        }
+    });
+}
+
+template<typename T>
+void reserveScratch(int width, int height) {
+    auto rowPlan = FFTPlanT<T>::get(width);
+    auto colPlan = FFTPlanT<T>::get(height);
+    size_t tileSize = static_cast<size_t>(columnBlockWidth<T>(height)) * height;
+    ThreadPool::global().forEachThread([&] {
+        scratchBuffer<T, RowScratch>(width);
+        scratchBuffer<T, TileScratch>(tileSize);
+        rowPlan->reserveScratch();
+        colPlan->reserveScratch();
+    });
+}
+
+template<typename T>
+size_t scratchBytes(int width, int height) {
+    size_t elements = static_cast<size_t>(width) + static_cast<size_t>(columnBlockWidth<T>(height)) * height;
+    return elements * sizeof(ComplexT<T>) + FFTPlanT<T>::get(width)->scratchBytes() +
+           FFTPlanT<T>::get(height)->scratchBytes();
+}
+
+template<typename T>
+void forwardR2C(const Image<T>& input, Spectrum<ComplexT<T>>& output) {
+    int width = input.width();
+    int height = input.height();
+    int half = halfWidth(width);
+
+    output.resize(half, height);
+
+    // 行变换
+    forwardRows(input, 0, height, output);
+
+    // 列变换：只需处理半频谱的 W/2+1 列
+    auto colPlan = FFTPlanT<T>::get(height);
+    transformColumnsParallel(output, output, *colPlan, false, half);
+}
+
+template<typename T>
+void inverseC2R(const Spectrum<ComplexT<T>>& input, int width, Image<T>& output) {
+    Spectrum<ComplexT<T>> work;
+    inverseC2R(input, width, output, work);
+}
+
+template<typename T>
+void inverseC2R(const Spectrum<ComplexT<T>>& input, int width, Image<T>& output,
+                Spectrum<ComplexT<T>>& work, int activeColumns) {
+    int height = input.height();
+    int half = input.width();
+    if (halfWidth(width) != half) {
+        throw std::invalid_argument("inverseC2R: spectrum width does not match image width");
+    }
+    if (activeColumns < 0 || activeColumns > half) {
+        activeColumns = half;
+    }
+
+    auto colPlan = FFTPlanT<T>::get(height);
+    work.resize(half, height);
+
+    // 列逆变换：直接从输入读取、写入工作区，省去一次整体拷贝。
+    // 全零列的逆变换仍为零，只变换前 activeColumns 列，其余列在行变换中按零处理
+    transformColumnsParallel(input, work, *colPlan, true, activeColumns);
+
+    output.resize(width, height);
+
+    // 行逆变换
+    inverseRows(work, width, activeColumns, output, 0);
+}
+
+template<typename T>
+ComplexT<T> centeredCoefficient(const Spectrum<ComplexT<T>>& half, int width, int x, int y) {
+    int height = half.height();
+    int kx = (x + width - width / 2) % width;
+    int ky = (y + height - height / 2) % height;
+    if (kx < half.width()) {
+        return half[ky][kx];
+    }
+    // 另一半由共轭对称得到
+    const ComplexT<T>& c = half[(height - ky) % height][width - kx];
+    return ComplexT<T>(c.real, -c.imag);
+}
+
+// 只提供 double 和 float 两种精度
+template void forwardRows<double>(const Image<double>&, int, int, Spectrum<Complex>&);
+template void forwardRows<float>(const Image<float>&, int, int, Spectrum<ComplexF>&);
+template void inverseRows<double>(const Spectrum<Complex>&, int, int, Image<double>&, int);
+template void inverseRows<float>(const Spectrum<ComplexF>&, int, int, Image<float>&, int);
+template void reserveScratch<double>(int, int);
+template void reserveScratch<float>(int, int);
+template size_t scratchBytes<double>(int, int);
+template size_t scratchBytes<float>(int, int);
+template void forwardR2C<double>(const Image<double>&, Spectrum<Complex>&);
+template void forwardR2C<float>(const Image<float>&, Spectrum<ComplexF>&);
+template void inverseC2R<double>(const Spectrum<Complex>&, int, Image<double>&);
+template void inverseC2R<float>(const Spectrum<ComplexF>&, int, Image<float>&);
+template void inverseC2R<double>(const Spectrum<Complex>&, int, Image<double>&, Spectrum<Complex>&, int);
+template void inverseC2R<float>(const Spectrum<ComplexF>&, int, Image<float>&, Spectrum<ComplexF>&, int);
+template Complex centeredCoefficient<double>(const Spectrum<Complex>&, int, int, int);
+template ComplexF centeredCoefficient<float>(const Spectrum<ComplexF>&, int, int, int);
+
+}
@@ -0,0 +1,278 @@
+#include "FFTKernels.h"
+#include <atomic>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #define FFT_X86_SIMD 1
+    // GCC 12 的 AVX-512 头文件在内联时会误报 -Wmaybe-uninitialized
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+    #include <immintrin.h>
+    #pragma GCC diagnostic pop
+#else
+    #define FFT_X86_SIMD 0
+#endif
+
+namespace {
+
+using PassD = void (*)(double*, const double*, int, int);
+using PassF = void (*)(float*, const float*, int, int);
+
+// 标量蝶形：前 start 个元素之后的部分由调用者决定，这里处理 [start, half)
+template<typename T>
+inline void scalarButterflies(T* a, T* b, const T* w, int start, int half) {
+    for (int j = start; j < half; j++) {
+        T br = b[2 * j], bi = b[2 * j + 1];
+        T wr = w[2 * j], wi = w[2 * j + 1];
+        T vr = br * wr - bi * wi;
+        T vi = br * wi + bi * wr;
+        T ur = a[2 * j], ui = a[2 * j + 1];
+        a[2 * j] = ur + vr;
+        a[2 * j + 1] = ui + vi;
+        b[2 * j] = ur - vr;
+        b[2 * j + 1] = ui - vi;
+    }
+}
+
+template<typename T>
+void passScalar(T* data, const T* twiddles, int n, int half) {
+    for (int i = 0; i < n; i += 2 * half) {
+        T* a = data + 2 * i;
+        scalarButterflies(a, a + 2 * half, twiddles, 0, half);
+    }
+}
+
+#if FFT_X86_SIMD
+
+// ---------- SSE2 ----------
+__attribute__((target("sse2")))
+void passSSE2(double* data, const double* twiddles, int n, int half) {
+    const __m128d signMask = _mm_set_pd(0.0, -0.0);
+    for (int i = 0; i < n; i += 2 * half) {
+        double* a = data + 2 * i;
+        double* b = a + 2 * half;
+        for (int j = 0; j < half; j++) {
+            __m128d w = _mm_loadu_pd(twiddles + 2 * j);
+            __m128d bv = _mm_loadu_pd(b + 2 * j);
+            __m128d wr = _mm_unpacklo_pd(w, w);
+            __m128d wi = _mm_unpackhi_pd(w, w);
+            __m128d bs = _mm_shuffle_pd(bv, bv, 1);
+            __m128d v = _mm_add_pd(_mm_mul_pd(bv, wr), _mm_xor_pd(_mm_mul_pd(bs, wi), signMask));
+            __m128d u = _mm_loadu_pd(a + 2 * j);
+            _mm_storeu_pd(a + 2 * j, _mm_add_pd(u, v));
+            _mm_storeu_pd(b + 2 * j, _mm_sub_pd(u, v));
+        }
+    }
+}
+
+__attribute__((target("sse2")))
+void passSSE2(float* data, const float* twiddles, int n, int half) {
+    const __m128 signMask = _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f);
+    for (int i = 0; i < n; i += 2 * half) {
+        float* a = data + 2 * i;
+        float* b = a + 2 * half;
+        int j = 0;
+        for (; j + 2 <= half; j += 2) {
+            __m128 w = _mm_loadu_ps(twiddles + 2 * j);
+            __m128 bv = _mm_loadu_ps(b + 2 * j);
+            __m128 wr = _mm_shuffle_ps(w, w, _MM_SHUFFLE(2, 2, 0, 0));
+            __m128 wi = _mm_shuffle_ps(w, w, _MM_SHUFFLE(3, 3, 1, 1));
+            __m128 bs = _mm_shuffle_ps(bv, bv, _MM_SHUFFLE(2, 3, 0, 1));
+            __m128 v = _mm_add_ps(_mm_mul_ps(bv, wr), _mm_xor_ps(_mm_mul_ps(bs, wi), signMask));
+            __m128 u = _mm_loadu_ps(a + 2 * j);
+            _mm_storeu_ps(a + 2 * j, _mm_add_ps(u, v));
+            _mm_storeu_ps(b + 2 * j, _mm_sub_ps(u, v));
+        }
+        scalarButterflies(a, b, twiddles, j, half);
+    }
+}
+
+// ---------- AVX2 + FMA ----------
+__attribute__((target("avx2,fma")))
+void passAVX2(double* data, const double* twiddles, int n, int half) {
+    for (int i = 0; i < n; i += 2 * half) {
+        double* a = data + 2 * i;
+        double* b = a + 2 * half;
+        int j = 0;
+        for (; j + 2 <= half; j += 2) {
+            __m256d w = _mm256_loadu_pd(twiddles + 2 * j);
+            __m256d bv = _mm256_loadu_pd(b + 2 * j);
+            __m256d wr = _mm256_movedup_pd(w);
+            __m256d wi = _mm256_permute_pd(w, 0xF);
+            __m256d bs = _mm256_permute_pd(bv, 0x5);
+            __m256d v = _mm256_fmaddsub_pd(bv, wr, _mm256_mul_pd(bs, wi));
+            __m256d u = _mm256_loadu_pd(a + 2 * j);
+            _mm256_storeu_pd(a + 2 * j, _mm256_add_pd(u, v));
+            _mm256_storeu_pd(b + 2 * j, _mm256_sub_pd(u, v));
+        }
+        scalarButterflies(a, b, twiddles, j, half);
+    }
+}
+
+__attribute__((target("avx2,fma")))
+void passAVX2(float* data, const float* twiddles, int n, int half) {
+    for (int i = 0; i < n; i += 2 * half) {
+        float* a = data + 2 * i;
+        float* b = a + 2 * half;
+        int j = 0;
+        for (; j + 4 <= half; j += 4) {
+            __m256 w = _mm256_loadu_ps(twiddles + 2 * j);
+            __m256 bv = _mm256_loadu_ps(b + 2 * j);
+            __m256 wr = _mm256_moveldup_ps(w);
+            __m256 wi = _mm256_movehdup_ps(w);
+            __m256 bs = _mm256_permute_ps(bv, 0xB1);
+            __m256 v = _mm256_fmaddsub_ps(bv, wr, _mm256_mul_ps(bs, wi));
+            __m256 u = _mm256_loadu_ps(a + 2 * j);
+            _mm256_storeu_ps(a + 2 * j, _mm256_add_ps(u, v));
+            _mm256_storeu_ps(b + 2 * j, _mm256_sub_ps(u, v));
+        }
+        scalarButterflies(a, b, twiddles, j, half);
+    }
+}
+
+// ---------- AVX-512F ----------
+__attribute__((target("avx512f")))
+void passAVX512(double* data, const double* twiddles, int n, int half) {
+    for (int i = 0; i < n; i += 2 * half) {
+        double* a = data + 2 * i;
+        double* b = a + 2 * half;
+        int j = 0;
+        for (; j + 4 <= half; j += 4) {
+            __m512d w = _mm512_loadu_pd(twiddles + 2 * j);
+            __m512d bv = _mm512_loadu_pd(b + 2 * j);
+            __m512d wr = _mm512_unpacklo_pd(w, w);
+            __m512d wi = _mm512_unpackhi_pd(w, w);
+            __m512d bs = _mm512_permute_pd(bv, 0x55);
+            __m512d v = _mm512_fmaddsub_pd(bv, wr, _mm512_mul_pd(bs, wi));
+            __m512d u = _mm512_loadu_pd(a + 2 * j);
+            _mm512_storeu_pd(a + 2 * j, _mm512_add_pd(u, v));
+            _mm512_storeu_pd(b + 2 * j, _mm512_sub_pd(u, v));
+        }
+        scalarButterflies(a, b, twiddles, j, half);
+    }
+}
+
+__attribute__((target("avx512f")))
+void passAVX512(float* data, const float* twiddles, int n, int half) {
+    for (int i = 0; i < n; i += 2 * half) {
+        float* a = data + 2 * i;
+        float* b = a + 2 * half;
+        int j = 0;
+        for (; j + 8 <= half; j += 8) {
+            __m512 w = _mm512_loadu_ps(twiddles + 2 * j);
+            __m512 bv = _mm512_loadu_ps(b + 2 * j);
+            __m512 wr = _mm512_moveldup_ps(w);
+            __m512 wi = _mm512_movehdup_ps(w);
+            __m512 bs = _mm512_permute_ps(bv, 0xB1);
+            __m512 v = _mm512_fmaddsub_ps(bv, wr, _mm512_mul_ps(bs, wi));
+            __m512 u = _mm512_loadu_ps(a + 2 * j);
+            _mm512_storeu_ps(a + 2 * j, _mm512_add_ps(u, v));
+            _mm512_storeu_ps(b + 2 * j, _mm512_sub_ps(u, v));
+        }
+        scalarButterflies(a, b, twiddles, j, half);
+    }
+}
+
+#endif // FFT_X86_SIMD
+
+// 各级别的内核表，下标为 SimdLevel；CPU不支持或未编译的级别为空
+struct KernelTable {
+    PassD passD[4];
+    PassF passF[4];
+    int minHalfD[4];   // 该级别一次处理的复数个数，半长小于它时降级使用更低级别
+    int minHalfF[4];
+};
+
+const KernelTable& kernelTable() {
+    static const KernelTable table = {
+#if FFT_X86_SIMD
+        { passScalar<double>, passSSE2, passAVX2, passAVX512 },
+        { passScalar<float>, passSSE2, passAVX2, passAVX512 },
+#else
+        { passScalar<double>, nullptr, nullptr, nullptr },
+        { passScalar<float>, nullptr, nullptr, nullptr },
+#endif
+        { 1, 1, 2, 4 },
+        { 1, 2, 4, 8 }
+    };
+    return table;
+}
+
+std::atomic<int> activeLevel{-1};
+
+int currentLevel() {
+    int level = activeLevel.load(std::memory_order_relaxed);
+    if (level < 0) {
+        level = static_cast<int>(FFTKernels::detectSimdLevel());
+        activeLevel.store(level, std::memory_order_relaxed);
+    }
+    return level;
+}
+
+}
+
+namespace FFTKernels {
+
+void radix2Pass(double* data, const double* twiddles, int n, int half) {
+    const KernelTable& table = kernelTable();
+    int level = currentLevel();
+    while (level > 0 && half < table.minHalfD[level]) {
+        level--;
+    }
+    table.passD[level](data, twiddles, n, half);
+}
+
+void radix2Pass(float* data, const float* twiddles, int n, int half) {
+    const KernelTable& table = kernelTable();
+    int level = currentLevel();
+    while (level > 0 && half < table.minHalfF[level]) {
+        level--;
+    }
+    table.passF[level](data, twiddles, n, half);
+}
+
+void radix2PassScalar(double* data, const double* twiddles, int n, int half) {
+    passScalar(data, twiddles, n, half);
+}
+
+void radix2PassScalar(float* data, const float* twiddles, int n, int half) {
+    passScalar(data, twiddles, n, half);
+}
+
+SimdLevel detectSimdLevel() {
+#if FFT_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return SimdLevel::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return SimdLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return SimdLevel::SSE2;
+    }
+#endif
+    return SimdLevel::Scalar;
+}
+
+SimdLevel activeSimdLevel() {
+    return static_cast<SimdLevel>(currentLevel());
+}
+
+SimdLevel setSimdLevel(SimdLevel level) {
+    int requested = static_cast<int>(level);
+    int supported = static_cast<int>(detectSimdLevel());
+    int effective = requested < supported ? requested : supported;
+    activeLevel.store(effective, std::memory_order_relaxed);
+    return static_cast<SimdLevel>(effective);
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SSE2: return "SSE2";
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::AVX512: return "AVX-512";
+        default: return "Scalar";
+    }
+}
+
+}
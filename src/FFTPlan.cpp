@@ -0,0 +1,540 @@
+#include "FFTPlan.h"
+#include "FFTKernels.h"
+#include "FFTCodelets.h"
+#include <cmath>
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <stdexcept>
+#include <utility>
+
+static_assert(sizeof(Complex) == 2 * sizeof(double), "Complex must be laid out as interleaved real/imag");
+static_assert(sizeof(ComplexF) == 2 * sizeof(float), "ComplexF must be laid out as interleaved real/imag");
+
+namespace {
+
+const double PI = 3.14159265358979323846;
+
+// 每种精度一个计划缓存
+template<typename T>
+struct PlanCache {
+    std::mutex mutex;
+    std::unordered_map<int, std::shared_ptr<const FFTPlanT<T>>> plans;
+};
+
+template<typename T>
+PlanCache<T>& planCache() {
+    static PlanCache<T> cache;
+    return cache;
+}
+
+// 以双精度计算单位根后转换为目标精度
+template<typename T>
+ComplexT<T> unitRoot(double angle) {
+    return ComplexT<T>(static_cast<T>(cos(angle)), static_cast<T>(sin(angle)));
+}
+
+// 混合基算法中奇数基（3/5/7）的 cos/sin 常数表
+template<typename T, int R>
+struct OddRadixTable {
+    T c[R];
+    T s[R];
+    OddRadixTable() {
+        for (int k = 0; k < R; k++) {
+            c[k] = static_cast<T>(cos(2.0 * PI * k / R));
+            s[k] = static_cast<T>(sin(2.0 * PI * k / R));
+        }
+    }
+};
+
+// R点DFT（R为奇数），利用 a[r] 与 a[R-r] 的对称性减少乘法
+template<typename T, int R>
+inline void oddRadixDFT(const ComplexT<T>* a, ComplexT<T>* c) {
+    static const OddRadixTable<T, R> table;
+    constexpr int H = (R - 1) / 2;
+    ComplexT<T> sum[H + 1], diff[H + 1];
+    c[0] = a[0];
+    for (int r = 1; r <= H; r++) {
+        sum[r] = a[r] + a[R - r];
+        diff[r] = a[r] - a[R - r];
+        c[0] = c[0] + sum[r];
+    }
+    for (int t = 1; t <= H; t++) {
+        T ar = a[0].real, ai = a[0].imag;
+        T br = 0, bi = 0;
+        for (int r = 1; r <= H; r++) {
+            int k = (r * t) % R;
+            ar += sum[r].real * table.c[k];
+            ai += sum[r].imag * table.c[k];
+            br += diff[r].real * table.s[k];
+            bi += diff[r].imag * table.s[k];
+        }
+        // -i·(b) = (b.imag, -b.real)
+        c[t] = ComplexT<T>(ar + bi, ai - br);
+        c[R - t] = ComplexT<T>(ar - bi, ai + br);
+    }
+}
+
+// Stockham 自动排序的一级：x -> y
+// 输入 x[q + s·(p + r·m)]，输出 y[q + s·(R·p + t)] = DFT_R(...)[t] · ω_len^(p·t)
+// Twiddled 为 false 时是最后一级（length == R）：旋转因子全为1，省去复数乘法
+template<typename T, int R, bool Twiddled>
+void stockhamStage(int length, int stride, const ComplexT<T>* tw, const ComplexT<T>* x, ComplexT<T>* y) {
+    int m = length / R;
+    int s = stride;
+    ComplexT<T> a[R], c[R];
+    for (int p = 0; p < m; p++) {
+        const ComplexT<T>* w = tw + static_cast<size_t>(p) * (R - 1);
+        for (int q = 0; q < s; q++) {
+            for (int r = 0; r < R; r++) {
+                a[r] = x[q + s * (p + r * m)];
+            }
+            if (R == 2) {
+                c[0] = a[0] + a[1];
+                c[1] = a[0] - a[1];
+            } else if (R == 4) {
+                ComplexT<T> t0 = a[0] + a[2];
+                ComplexT<T> t1 = a[0] - a[2];
+                ComplexT<T> t2 = a[1] + a[3];
+                ComplexT<T> d = a[1] - a[3];
+                ComplexT<T> t3(d.imag, -d.real);  // (a1 - a3)·(-i)
+                c[0] = t0 + t2;
+                c[1] = t1 + t3;
+                c[2] = t0 - t2;
+                c[3] = t1 - t3;
+            } else {
+                oddRadixDFT<T, R>(a, c);
+            }
+            ComplexT<T>* out = y + q + static_cast<size_t>(s) * R * p;
+            out[0] = c[0];
+            for (int t = 1; t < R; t++) {
+                out[static_cast<size_t>(s) * t] = Twiddled ? c[t] * w[t - 1] : c[t];
+            }
+        }
+    }
+}
+
+// 按基数分派到展开的 Stockham 级
+template<typename T, bool Twiddled, typename Stage>
+void runStockhamStage(const Stage& stage, const ComplexT<T>* tw, const ComplexT<T>* x, ComplexT<T>* y) {
+    switch (stage.radix) {
+        case 2: stockhamStage<T, 2, Twiddled>(stage.length, stage.stride, tw, x, y); break;
+        case 3: stockhamStage<T, 3, Twiddled>(stage.length, stage.stride, tw, x, y); break;
+        case 4: stockhamStage<T, 4, Twiddled>(stage.length, stage.stride, tw, x, y); break;
+        case 5: stockhamStage<T, 5, Twiddled>(stage.length, stage.stride, tw, x, y); break;
+        case 7: stockhamStage<T, 7, Twiddled>(stage.length, stage.stride, tw, x, y); break;
+    }
+}
+
+// 临时缓冲区的用途。算法之间可能嵌套（四步法的子计划可能是混合基，
+// Bluestein 的卷积计划可能是四步法），各自使用独立的缓冲区
+enum ScratchSlot {
+    StockhamScratch,
+    BluesteinScratch,
+    FourStepScratch
+};
+
+// 每个线程独立的临时缓冲区，容量只增不减，稳定后不再分配内存
+template<typename T, int Slot>
+ComplexT<T>* scratchBuffer(size_t size) {
+    thread_local std::vector<ComplexT<T>> scratch;
+    if (scratch.size() < size) {
+        scratch.resize(size);
+    }
+    return scratch.data();
+}
+
+// 从 n 中依次提取 4/2/3/5/7 因子，n 变为无法分解的剩余部分
+std::vector<int> radixFactors(int& n) {
+    std::vector<int> factors;
+    for (int radix : {4, 2, 3, 5, 7}) {
+        while (n % radix == 0) {
+            factors.push_back(radix);
+            n /= radix;
+        }
+    }
+    return factors;
+}
+
+// 四步法每次拷入小缓冲区的列数 / 行数
+constexpr int FourStepBlock = 8;
+
+// 在 n 的约数中找最接近 sqrt(n) 的一个，返回 1 表示无法分解
+int balancedDivisor(int n) {
+    int best = 1;
+    for (int d = 2; static_cast<long long>(d) * d <= n; d++) {
+        if (n % d == 0) {
+            best = d;
+        }
+    }
+    return best;
+}
+
+}
+
+template<typename T>
+FFTPlanT<T>::FFTPlanT(int n) : n(n), algo(Algorithm::Radix2) {
+    if (n <= 0) {
+        throw std::invalid_argument("FFTPlan: size must be positive");
+    }
+
+    // 分解为 4/2/3/5/7 的乘积
+    int rest = n;
+    radixFactors(rest);
+
+    // 四步法的子计划必须短于阈值，不会再次嵌套四步法（两者共用同一个临时缓冲区）
+    int divisor = (rest == 1 && n >= FourStepThreshold) ? balancedDivisor(n) : 1;
+    if (divisor > 1 && n / divisor < FourStepThreshold) {
+        algo = Algorithm::FourStep;
+        initFourStep();
+    } else if ((n & (n - 1)) == 0) {
+        algo = Algorithm::Radix2;
+        initRadix2();
+    } else if (rest == 1) {
+        algo = Algorithm::MixedRadix;
+        initMixedRadix();
+    } else {
+        algo = Algorithm::Bluestein;
+        initBluestein();
+    }
+}
+
+template<typename T>
+void FFTPlanT<T>::initRadix2() {
+    int log2n = 0;
+    while ((1 << log2n) < n) {
+        log2n++;
+    }
+
+    // 位反转置换表
+    bitReversal.resize(n);
+    for (int i = 0; i < n; i++) {
+        int reversed = 0;
+        for (int b = 0, v = i; b < log2n; b++, v >>= 1) {
+            reversed = (reversed << 1) | (v & 1);
+        }
+        bitReversal[i] = reversed;
+    }
+
+    // 每个旋转因子直接由三角函数求得，避免递推累积误差
+    twiddles.resize(n > 1 ? n - 1 : 0);
+    for (int half = 1; half < n; half *= 2) {
+        ComplexType* w = twiddles.data() + (half - 1);
+        for (int j = 0; j < half; j++) {
+            w[j] = unitRoot<T>(-PI * j / half);
+        }
+    }
+}
+
+template<typename T>
+void FFTPlanT<T>::initMixedRadix() {
+    // 最后 leafSize 点由展开的混合基 codelet 完成，其余因子逐级做 Stockham 级
+    leafSize = FFTCodelets::mixedLeafSize(n);
+    int rest = n / leafSize;
+    std::vector<int> factors = radixFactors(rest);
+
+    int length = n;
+    int stride = 1;
+    for (int radix : factors) {
+        Stage stage;
+        stage.radix = radix;
+        stage.length = length;
+        stage.stride = stride;
+        stage.twiddleOffset = twiddles.size();
+
+        // ω_length^(p·t)，p < length/radix，1 <= t < radix
+        int m = length / radix;
+        for (int p = 0; p < m; p++) {
+            for (int t = 1; t < radix; t++) {
+                twiddles.push_back(unitRoot<T>(-2.0 * PI * (static_cast<double>(p) * t) / length));
+            }
+        }
+
+        stages.push_back(stage);
+        length = m;
+        stride *= radix;
+    }
+}
+
+template<typename T>
+void FFTPlanT<T>::initBluestein() {
+    // 卷积长度取不小于 2n-1 的2的幂次
+    int m = 1;
+    while (m < 2 * n - 1) {
+        m *= 2;
+    }
+    convolutionPlan = get(m);
+
+    // chirp[k] = exp(-πi·k²/n)，k² 对 2n 取模以保持大 k 时的精度
+    chirp.resize(n);
+    for (int k = 0; k < n; k++) {
+        long long k2 = (static_cast<long long>(k) * k) % (2LL * n);
+        chirp[k] = unitRoot<T>(-PI * static_cast<double>(k2) / n);
+    }
+
+    // 卷积核 b[k] = conj(chirp[|k|])，按循环方式放置
+    chirpSpectrum.assign(m, ComplexType(0, 0));
+    chirpSpectrum[0] = ComplexType(chirp[0].real, -chirp[0].imag);
+    for (int k = 1; k < n; k++) {
+        ComplexType b(chirp[k].real, -chirp[k].imag);
+        chirpSpectrum[k] = b;
+        chirpSpectrum[m - k] = b;
+    }
+    convolutionPlan->forward(chirpSpectrum.data());
+
+    // 把逆变换的 1/m 归一化合并进卷积核
+    T scale = static_cast<T>(1.0 / m);
+    for (auto& c : chirpSpectrum) {
+        c.real *= scale;
+        c.imag *= scale;
+    }
+}
+
+template<typename T>
+void FFTPlanT<T>::initFourStep() {
+    n1 = balancedDivisor(n);
+    n2 = n / n1;
+    plan1 = get(n1);
+    plan2 = get(n2);
+
+    // exp(-2πi·j2·k1/n)，j2·k1 对 n 取模以保持精度
+    twiddles.resize(n);
+    for (int j2 = 0; j2 < n2; j2++) {
+        for (int k1 = 0; k1 < n1; k1++) {
+            long long e = (static_cast<long long>(j2) * k1) % n;
+            twiddles[static_cast<size_t>(j2) * n1 + k1] = unitRoot<T>(-2.0 * PI * static_cast<double>(e) / n);
+        }
+    }
+}
+
+template<typename T>
+void FFTPlanT<T>::reserveScratch() const {
+    switch (algo) {
+        case Algorithm::Radix2:
+            break;
+        case Algorithm::MixedRadix:
+            scratchBuffer<T, StockhamScratch>(n);
+            break;
+        case Algorithm::Bluestein:
+            scratchBuffer<T, BluesteinScratch>(convolutionPlan->size());
+            convolutionPlan->reserveScratch();
+            break;
+        case Algorithm::FourStep:
+            scratchBuffer<T, FourStepScratch>(static_cast<size_t>(n) + static_cast<size_t>(FourStepBlock) * n1);
+            plan1->reserveScratch();
+            plan2->reserveScratch();
+            break;
+    }
+}
+
+template<typename T>
+size_t FFTPlanT<T>::scratchBytes() const {
+    switch (algo) {
+        case Algorithm::Radix2:
+            return 0;
+        case Algorithm::MixedRadix:
+            return static_cast<size_t>(n) * sizeof(ComplexType);
+        case Algorithm::Bluestein:
+            return static_cast<size_t>(convolutionPlan->size()) * sizeof(ComplexType) + convolutionPlan->scratchBytes();
+        case Algorithm::FourStep:
+            return (static_cast<size_t>(n) + static_cast<size_t>(FourStepBlock) * n1) * sizeof(ComplexType) +
+                   plan1->scratchBytes() + plan2->scratchBytes();
+    }
+    return 0;
+}
+
+template<typename T>
+void FFTPlanT<T>::execute(ComplexType* data) const {
+    switch (algo) {
+        case Algorithm::Radix2:
+            executeRadix2(data);
+            break;
+        case Algorithm::MixedRadix:
+            executeMixedRadix(data);
+            break;
+        case Algorithm::Bluestein:
+            executeBluestein(data);
+            break;
+        case Algorithm::FourStep:
+            executeFourStep(data);
+            break;
+    }
+}
+
+template<typename T>
+void FFTPlanT<T>::executeRadix2(ComplexType* data) const {
+    // 小尺寸直接使用编译期展开的 codelet
+    if (n <= FFTCodelets::MaxSize) {
+        FFTCodelets::transform(data, n);
+        return;
+    }
+
+    // 位反转重排
+    for (int i = 0; i < n; i++) {
+        int j = bitReversal[i];
+        if (i < j) {
+            std::swap(data[i], data[j]);
+        }
+    }
+
+    // 前 log2(LeafSize) 级在长度为 LeafSize 的块内完成，由 codelet 展开执行
+    FFTCodelets::leaves<T, FFTCodelets::LeafSize>(data, n);
+
+    // 其余各级蝶形运算（由运行时选择的SIMD内核执行）
+    T* raw = reinterpret_cast<T*>(data);
+    for (int half = FFTCodelets::LeafSize; half < n; half *= 2) {
+        const T* w = reinterpret_cast<const T*>(twiddles.data() + (half - 1));
+        FFTKernels::radix2Pass(raw, w, n, half);
+    }
+}
+
+template<typename T>
+void FFTPlanT<T>::executeMixedRadix(ComplexType* data) const {
+    ComplexType* x = data;
+    ComplexType* y = scratchBuffer<T, StockhamScratch>(n);
+
+    for (const Stage& stage : stages) {
+        const ComplexType* tw = twiddles.data() + stage.twiddleOffset;
+        if (stage.length == stage.radix) {
+            runStockhamStage<T, false>(stage, tw, x, y);
+        } else {
+            runStockhamStage<T, true>(stage, tw, x, y);
+        }
+        std::swap(x, y);
+    }
+    // 各级之后剩余的 leafSize 点变换：n/leafSize 个交错子序列各做一次，原地完成
+    if (leafSize > 1) {
+        FFTCodelets::stridedLeaves(x, leafSize, n / leafSize);
+    }
+
+    // 级数为奇数时结果位于临时缓冲区
+    if (x != data) {
+        std::copy(x, x + n, data);
+    }
+}
+
+template<typename T>
+void FFTPlanT<T>::executeBluestein(ComplexType* data) const {
+    int m = convolutionPlan->size();
+    ComplexType* buffer = scratchBuffer<T, BluesteinScratch>(m);
+
+    for (int k = 0; k < n; k++) {
+        buffer[k] = data[k] * chirp[k];
+    }
+    std::fill(buffer + n, buffer + m, ComplexType(0, 0));
+
+    // 循环卷积：FFT -> 乘卷积核频谱 -> 逆FFT（借助共轭实现）
+    convolutionPlan->forward(buffer);
+    for (int k = 0; k < m; k++) {
+        ComplexType c = buffer[k] * chirpSpectrum[k];
+        buffer[k] = ComplexType(c.real, -c.imag);
+    }
+    convolutionPlan->forward(buffer);
+
+    for (int k = 0; k < n; k++) {
+        ComplexType c(buffer[k].real, -buffer[k].imag);
+        data[k] = c * chirp[k];
+    }
+}
+
+// 输入视为 n1×n2 矩阵 x[j1][j2]（下标 j1·n2 + j2），输出下标 k1 + n1·k2：
+// 1. 每 Block 列为一组拷入连续的小缓冲区，对每列做 n1 点FFT，乘以 exp(-2πi·j2·k1/n)，
+//    按行主序写入工作区 Y[k1][j2]
+// 2. 每 Block 行为一组，对每行（连续）做 n2 点FFT，再按转置顺序写回 data，
+//    写回时每个 k2 对应 Block 个连续元素
+// 每次FFT只处理能放进缓存的短序列，最终转置与第2步合并，不需要额外的整体转置和拷贝
+template<typename T>
+void FFTPlanT<T>::executeFourStep(ComplexType* data) const {
+    constexpr int Block = FourStepBlock;
+    ComplexType* work = scratchBuffer<T, FourStepScratch>(static_cast<size_t>(n) + static_cast<size_t>(Block) * n1);
+    ComplexType* tile = work + n;
+
+    for (int j0 = 0; j0 < n2; j0 += Block) {
+        int count = std::min(Block, n2 - j0);
+        for (int j1 = 0; j1 < n1; j1++) {
+            const ComplexType* src = data + static_cast<size_t>(j1) * n2 + j0;
+            for (int b = 0; b < count; b++) {
+                tile[static_cast<size_t>(b) * n1 + j1] = src[b];
+            }
+        }
+        for (int b = 0; b < count; b++) {
+            ComplexType* column = tile + static_cast<size_t>(b) * n1;
+            const ComplexType* w = twiddles.data() + static_cast<size_t>(j0 + b) * n1;
+            plan1->forward(column);
+            for (int k1 = 0; k1 < n1; k1++) {
+                column[k1] = column[k1] * w[k1];
+            }
+        }
+        for (int k1 = 0; k1 < n1; k1++) {
+            ComplexType* dst = work + static_cast<size_t>(k1) * n2 + j0;
+            for (int b = 0; b < count; b++) {
+                dst[b] = tile[static_cast<size_t>(b) * n1 + k1];
+            }
+        }
+    }
+
+    for (int k0 = 0; k0 < n1; k0 += Block) {
+        int count = std::min(Block, n1 - k0);
+        for (int b = 0; b < count; b++) {
+            plan2->forward(work + static_cast<size_t>(k0 + b) * n2);
+        }
+        for (int k2 = 0; k2 < n2; k2++) {
+            ComplexType* dst = data + static_cast<size_t>(k2) * n1 + k0;
+            for (int b = 0; b < count; b++) {
+                dst[b] = work[static_cast<size_t>(k0 + b) * n2 + k2];
+            }
+        }
+    }
+}
+
+template<typename T>
+void FFTPlanT<T>::forward(ComplexType* data) const {
+    execute(data);
+}
+
+template<typename T>
+void FFTPlanT<T>::inverse(ComplexType* data) const {
+    // 共轭
+    for (int i = 0; i < n; i++) {
+        data[i].imag = -data[i].imag;
+    }
+
+    execute(data);
+
+    // 共轭并归一化
+    T scale = static_cast<T>(1.0 / n);
+    for (int i = 0; i < n; i++) {
+        data[i].real *= scale;
+        data[i].imag = -data[i].imag * scale;
+    }
+}
+
+template<typename T>
+std::shared_ptr<const FFTPlanT<T>> FFTPlanT<T>::get(int n) {
+    PlanCache<T>& cache = planCache<T>();
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        auto it = cache.plans.find(n);
+        if (it != cache.plans.end()) {
+            return it->second;
+        }
+    }
+
+    // 在锁外构造：Bluestein 计划构造时会递归获取卷积长度的计划
+    auto plan = std::make_shared<const FFTPlanT>(n);
+
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    // 其他线程可能已抢先创建，以缓存中的为准
+    auto result = cache.plans.emplace(n, plan);
+    return result.first->second;
+}
+
+template<typename T>
+void FFTPlanT<T>::clearCache() {
+    PlanCache<T>& cache = planCache<T>();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.plans.clear();
+}
+
+template class FFTPlanT<double>;
+template class FFTPlanT<float>;
@@ -0,0 +1,180 @@
+#include "FilterChain.h"
+#include "FilterGeometry.h"
+#include "FFT2D.h"
+#include "ThreadPool.h"
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+// 高斯陷波在该倍数的半径之外衰减不足 exp(-18)，视为 1
+constexpr double SmoothNotchReach = 6.0;
+
+// 理想径向滤波保留的 d² 区间 (zeroAtMost, keepAtMost]，与 ImageProcessor 的理想滤波判据一致
+void idealRange(const FilterSpec& spec, double radiusScale, long long& zeroAtMost, long long& keepAtMost) {
+    zeroAtMost = -1;
+    keepAtMost = std::numeric_limits<long long>::max();
+    switch (spec.band) {
+        case FilterBand::HighPass:
+            zeroAtMost = FilterGeometry::squaredRadiusBelow(spec.cutoff * radiusScale);
+            break;
+        case FilterBand::BandPass:
+            zeroAtMost = FilterGeometry::squaredRadiusBelow(spec.bandLow * radiusScale);
+            keepAtMost = FilterGeometry::squaredRadiusAtMost(spec.bandHigh * radiusScale);
+            break;
+        case FilterBand::LowPass:
+        default:
+            keepAtMost = FilterGeometry::squaredRadiusAtMost(spec.cutoff * radiusScale);
+            break;
+    }
+}
+
+// 在一行（中心化纵坐标 dy）的 [begin, end) 列中应用以 (cu, cv) 为中心的陷波
+void applyNotch(Complex* row, int begin, int end, int dy, int cu, int cv, double radius, bool smooth) {
+    if (smooth && radius <= 0.0) {
+        return;
+    }
+    double reach = smooth ? radius * SmoothNotchReach : radius;
+    double offsetY = static_cast<double>(dy - cv);
+    double remaining = reach * reach - offsetY * offsetY;
+    if (remaining < 0.0) {
+        return;
+    }
+    double span = std::sqrt(remaining);
+    double first = std::max(static_cast<double>(begin), std::ceil(cu - span));
+    double last = std::min(static_cast<double>(end - 1), std::floor(cu + span));
+    double radiusSquared = radius * radius;
+    for (int x = static_cast<int>(first); x <= static_cast<int>(last); x++) {
+        double offsetX = static_cast<double>(x - cu);
+        double d2 = offsetX * offsetX + offsetY * offsetY;
+        if (smooth) {
+            double gain = 1.0 - std::exp(-d2 / (2.0 * radiusSquared));
+            row[x] = Complex(row[x].real * gain, row[x].imag * gain);
+        } else if (d2 <= radiusSquared) {
+            row[x] = Complex();
+        }
+    }
+}
+
+}
+
+FilterChain& FilterChain::addRadial(const FilterSpec& spec) {
+    // 复用已有的槽位，参数不变时查找表不必重建
+    if (radialCount == radials.size()) {
+        radials.emplace_back();
+    }
+    radials[radialCount++].spec = spec;
+    return *this;
+}
+
+FilterChain& FilterChain::addGain(double gain) {
+    gains.push_back(gain);
+    return *this;
+}
+
+FilterChain& FilterChain::addNotch(int u, int v, double radius, bool smooth) {
+    notches.push_back({u, v, std::max(radius, 0.0), smooth});
+    return *this;
+}
+
+FilterChain& FilterChain::addCustom(TransferFunction function) {
+    if (function) {
+        customs.push_back(std::move(function));
+    }
+    return *this;
+}
+
+void FilterChain::clear() {
+    radialCount = 0;
+    gains.clear();
+    notches.clear();
+    customs.clear();
+}
+
+int FilterChain::apply(const Spectrum<Complex>& input, int width, double radiusScale, Spectrum<Complex>& output) {
+    if (input.empty()) {
+        output.clear();
+        return 0;
+    }
+
+    int height = input.height();
+    const FilterGeometry& geometry = *FilterGeometry::get(width, height);
+    int half = geometry.halfWidth();
+    long long maxSquared = static_cast<long long>(width / 2) * (width / 2) +
+                           static_cast<long long>(height / 2) * (height / 2);
+
+    // 理想掩膜与各查找表的支撑范围求交：只有 zeroAtMost < d² <= keepAtMost 的系数可能非零
+    long long zeroAtMost = -1;
+    long long keepAtMost = std::numeric_limits<long long>::max();
+    activeTables.clear();
+    for (size_t i = 0; i < radialCount; i++) {
+        RadialStage& stage = radials[i];
+        if (stage.spec.shape == FilterShape::Ideal) {
+            long long low, high;
+            idealRange(stage.spec, radiusScale, low, high);
+            zeroAtMost = std::max(zeroAtMost, low);
+            keepAtMost = std::min(keepAtMost, high);
+            continue;
+        }
+        // 覆盖范围更大的表对较小的尺寸同样适用，在不同分辨率之间切换时不必重建
+        if (stage.spec != stage.builtSpec || radiusScale != stage.builtScale || maxSquared > stage.builtMaxSquared) {
+            stage.lut.build(stage.spec, radiusScale, maxSquared);
+            stage.builtSpec = stage.spec;
+            stage.builtScale = radiusScale;
+            stage.builtMaxSquared = maxSquared;
+        }
+        keepAtMost = std::min(keepAtMost, stage.lut.supportSquared());
+        activeTables.push_back(&stage.lut);
+    }
+
+    double gain = 1.0;
+    for (double g : gains) {
+        gain *= g;
+    }
+    if (gain == 0.0) {
+        keepAtMost = -1;
+    }
+
+    bool perCoefficient = !activeTables.empty() || !customs.empty();
+    output.resize(half, height);
+    ThreadPool::global().parallelFor(0, height, 0, [&](int yBegin, int yEnd) {
+        for (int y = yBegin; y < yEnd; y++) {
+            const Complex* in = input.row(y);
+            Complex* out = output.row(y);
+            long long dy2 = geometry.rowOffsetSquared(y);
+            int dy = FFT2D::centeredOffset(y, height);
+            int begin = geometry.columnsWithin(y, zeroAtMost);
+            int end = std::max(begin, geometry.columnsWithin(y, keepAtMost));
+            std::fill(out, out + begin, Complex());
+            std::fill(out + end, out + half, Complex());
+
+            if (!perCoefficient) {
+                for (int x = begin; x < end; x++) {
+                    out[x] = Complex(in[x].real * gain, in[x].imag * gain);
+                }
+            } else {
+                for (int x = begin; x < end; x++) {
+                    double g = gain;
+                    long long d2 = static_cast<long long>(x) * x + dy2;
+                    for (const RadialTransferLUT* table : activeTables) {
+                        g *= (*table)(d2);
+                    }
+                    for (const TransferFunction& function : customs) {
+                        g *= function(x, dy);
+                    }
+                    out[x] = Complex(in[x].real * g, in[x].imag * g);
+                }
+            }
+
+            // 半频谱只存 u >= 0 的一半，(u, v) 与 (-u, -v) 两个中心都要处理才能保持共轭对称
+            for (const Notch& notch : notches) {
+                applyNotch(out, begin, end, dy, notch.u, notch.v, notch.radius, notch.smooth);
+                applyNotch(out, begin, end, dy, -notch.u, -notch.v, notch.radius, notch.smooth);
+            }
+        }
+    });
+
+    // 直流所在的第 0 行最宽
+    return geometry.columnsWithin(0, keepAtMost);
+}
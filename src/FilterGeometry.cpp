@@ -0,0 +1,117 @@
+#include "FilterGeometry.h"
+#include "FFT2D.h"
+#include "ThreadPool.h"
+#include <cmath>
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace {
+
+struct GeometryCache {
+    std::mutex mutex;
+    std::map<std::pair<int, int>, std::shared_ptr<const FilterGeometry>> entries;
+};
+
+GeometryCache& geometryCache() {
+    static GeometryCache cache;
+    return cache;
+}
+
+// 半径上限，避免平方后溢出（远大于任何图像的对角线）
+constexpr double MaxRadius = 2.0e9;
+
+}
+
+FilterGeometry::FilterGeometry(int width, int height)
+    : fullWidth(width), fullHeight(height), half(FFT2D::halfWidth(width)), rowOffsetSq(height) {
+    for (int y = 0; y < height; y++) {
+        long long dy = FFT2D::centeredOffset(y, height);
+        rowOffsetSq[y] = dy * dy;
+    }
+}
+
+long long FilterGeometry::squaredRadiusAtMost(double radius) {
+    if (!(radius >= 0.0)) {
+        return -1;
+    }
+    radius = std::min(radius, MaxRadius);
+    // 先由 r² 估计，再按与逐点比较完全相同的判据 sqrt(d²) <= r 修正舍入误差
+    long long t = static_cast<long long>(std::floor(radius * radius));
+    while (std::sqrt(static_cast<double>(t + 1)) <= radius) {
+        t++;
+    }
+    while (t >= 0 && std::sqrt(static_cast<double>(t)) > radius) {
+        t--;
+    }
+    return t;
+}
+
+long long FilterGeometry::squaredRadiusBelow(double radius) {
+    if (!(radius > 0.0)) {
+        return -1;
+    }
+    radius = std::min(radius, MaxRadius);
+    long long t = static_cast<long long>(std::floor(radius * radius));
+    while (std::sqrt(static_cast<double>(t + 1)) < radius) {
+        t++;
+    }
+    while (t >= 0 && std::sqrt(static_cast<double>(t)) >= radius) {
+        t--;
+    }
+    return t;
+}
+
+int FilterGeometry::columnsWithin(int y, long long threshold) const {
+    long long remaining = threshold - rowOffsetSq[y];
+    if (remaining < 0) {
+        return 0;
+    }
+    if (remaining >= static_cast<long long>(half) * half) {
+        return half;
+    }
+    long long k = static_cast<long long>(std::sqrt(static_cast<double>(remaining)));
+    while ((k + 1) * (k + 1) <= remaining) {
+        k++;
+    }
+    while (k * k > remaining) {
+        k--;
+    }
+    return static_cast<int>(std::min<long long>(k + 1, half));
+}
+
+void FilterGeometry::select(const Spectrum<Complex>& src, Spectrum<Complex>& dst,
+                            long long zeroAtMost, long long keepAtMost) const {
+    dst.resize(half, fullHeight);
+    ThreadPool::global().parallelFor(0, fullHeight, 0, [&](int yBegin, int yEnd) {
+        for (int y = yBegin; y < yEnd; y++) {
+            int begin = columnsWithin(y, zeroAtMost);
+            int end = std::max(begin, columnsWithin(y, keepAtMost));
+            const Complex* in = src.row(y);
+            Complex* out = dst.row(y);
+            std::fill(out, out + begin, Complex());
+            std::copy(in + begin, in + end, out + begin);
+            std::fill(out + end, out + half, Complex());
+        }
+    });
+}
+
+std::shared_ptr<const FilterGeometry> FilterGeometry::get(int width, int height) {
+    GeometryCache& cache = geometryCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto key = std::make_pair(width, height);
+    auto it = cache.entries.find(key);
+    if (it != cache.entries.end()) {
+        return it->second;
+    }
+    auto geometry = std::make_shared<const FilterGeometry>(width, height);
+    cache.entries.emplace(key, geometry);
+    return geometry;
+}
+
+void FilterGeometry::clearCache() {
+    GeometryCache& cache = geometryCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.entries.clear();
+}
@@ -1,4 +1,6 @@
 #include "GUI.h"
+#include "FFTKernels.h"
+#include "ThreadPool.h"
 #include <sstream>
 #include <iomanip>
 #include <thread>
@@ -115,7 +117,7 @@ public:
             {"保存当前图像", "Save Current Image"},
             {"直接拖拽图像文件到窗口", "Drag image files directly to window"},
             {"等常见格式", "and other common formats"},
-            {"图像会自动调整为2的幂次尺寸", "Images will be automatically resized to power-of-2 dimensions"},
+            {"支持任意尺寸的图像，无需缩放", "Images of any size are supported without resizing"},
             {"可实时调整滤波器参数查看效果", "Real-time filter parameter adjustment"},
             {"所有窗口都可独立移动和调整", "All windows can be moved and resized independently"},
             {"关闭", "Close"},
@@ -419,14 +421,27 @@ GUI::GUI() :
     frequencyMagnitudeTexture(0),
     frequencyPhaseTexture(0),
     filteredImageTexture(0),
+    filteredPreviewLevel(0),
     currentDisplayMode(DisplayMode::ORIGINAL_IMAGE),
     currentColorMap(ColorMap::GRAYSCALE),
     filterType(0),
+    filterShape(0),
+    butterworthOrder(2),
+    raisedCosineRolloff(0.5f),
     lowPassCutoff(0.5f),
     highPassCutoff(0.5f),
     bandPassLow(0.2f),
     bandPassHigh(0.8f),
     autoApplyFilter(false),
+    useBandCache(false),
+    bandCacheBands(16),
+    notchEnabled(false),
+    notchU(0),
+    notchV(0),
+    notchRadius(3.0f),
+    notchSmooth(false),
+    useTiledFilter(false),
+    hasSpectrumDiagnostics(false),
     show3DWindow(false),
     framebufferID(0),
     colorTextureID(0), 
@@ -625,6 +640,7 @@ void GUI::run() {
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
         
+        pollFilterPreview();
         drawMainMenuBar();
         
         if (showImageWindow) drawImageWindow();
@@ -688,6 +704,7 @@ void GUI::drawMainMenuBar() {
                 resetFilter();
             }
             if (ImGui::MenuItem("执行FFT", nullptr, false, processor->getWidth() > 0)) {
+                previewWorker.cancelAndWait();
                 processor->fft2D();
                 updateImageTextures();
             }
@@ -772,7 +789,7 @@ void GUI::drawImageWindow() {
                 break;
                 
             case DisplayMode::FILTERED_IMAGE:
-                drawImageWithLegend(filteredImageTexture, processor->getWidth(), 
+                drawImageWithLegend(filteredDisplayTexture(), processor->getWidth(), 
                                   processor->getHeight(), "滤波后图像", filteredStats);
                 break;
                 
@@ -788,7 +805,7 @@ void GUI::drawImageWindow() {
                 ImGui::SameLine();
                 
                 ImGui::BeginChild("Filtered", ImVec2(imageSize.x, 0), true);
-                drawImageWithLegend(filteredImageTexture, processor->getWidth(), 
+                drawImageWithLegend(filteredDisplayTexture(), processor->getWidth(), 
                                   processor->getHeight(), "滤波后图像", filteredStats);
                 ImGui::EndChild();
                 break;
@@ -892,6 +909,7 @@ void GUI::drawFrequencyWindow() {
                 ImGui::Text("频域数据可用于滤波处理");
                 
                 if (ImGui::Button("重新计算FFT")) {
+                    previewWorker.cancelAndWait();
                     processor->fft2D();
                     updateImageTextures();
                 }
@@ -923,10 +941,84 @@ void GUI::drawControlWindow() {
         
         ImGui::Spacing();
         ImGui::Text("像素总数: %d", processor->getWidth() * processor->getHeight());
+        ImGui::Text("FFT指令集: %s", FFTKernels::simdLevelName(FFTKernels::activeSimdLevel()));
+        
+        int threads = processor->getThreadCount();
+        if (ImGui::SliderInt("FFT线程数", &threads, 1, ThreadPool::hardwareThreads())) {
+            previewWorker.waitIdle();
+            processor->setThreadCount(threads);
+        }
+        
+        int precisionIndex = processor->getPrecision() == Precision::Float ? 1 : 0;
+        const char* precisionNames[] = { "双精度 (double)", "单精度 (float)" };
+        if (ImGui::Combo("FFT精度", &precisionIndex, precisionNames, 2)) {
+            previewWorker.cancelAndWait();
+            processor->setPrecision(precisionIndex == 1 ? Precision::Float : Precision::Double);
+            processor->fft2D();
+            updateImageTextures();
+        }
+        ImGui::SameLine();
+        GuiUtils::helpMarker("单精度：变换以 float 执行，频谱仍以双精度保存（前后各多一次转换），\n"
+                             "用于评估单精度的误差；双精度用于精确分析");
+        
+        bool validation = processor->isValidationEnabled();
+        if (ImGui::Checkbox("数值校验", &validation)) {
+            // 预览任务在变换中读取该设置，先等待其完成
+            previewWorker.waitIdle();
+            processor->setValidationEnabled(validation);
+        }
+        ImGui::SameLine();
+        GuiUtils::helpMarker("变换前后检查 NaN/Inf 并输出值域，会增加额外的遍历");
+
+        bool linearGray = processor->getGrayMode() == GrayMode::LinearLight;
+        if (ImGui::Checkbox("sRGB线性化", &linearGray)) {
+            // 灰度转换在加载时完成，重新加载当前文件使设置生效
+            if (currentImagePath.empty()) {
+                previewWorker.waitIdle();
+                processor->setGrayMode(linearGray ? GrayMode::LinearLight : GrayMode::Luma);
+            } else {
+                previewWorker.cancelAndWait();
+                processor->setGrayMode(linearGray ? GrayMode::LinearLight : GrayMode::Luma);
+                if (processor->loadImage(currentImagePath)) {
+                    processor->fft2D();
+                    updateImageTextures();
+                }
+            }
+        }
+        ImGui::SameLine();
+        GuiUtils::helpMarker("转换为灰度前按 sRGB 传递函数解码为线性光强，并使用 Rec.709 权重；\n"
+                             "频谱反映物理光强而不是编码值，图像显示会偏暗");
+
+        int budgetGB = static_cast<int>(processor->getMemoryBudget() >> 30);
+        if (ImGui::SliderInt("内存预算 (GB)", &budgetGB, 1, 64)) {
+            previewWorker.waitIdle();
+            processor->setMemoryBudget(static_cast<size_t>(budgetGB) << 30);
+        }
+        ImGui::SameLine();
+        GuiUtils::helpMarker("加载图像和频带缓存在分配前按此预算检查；\n"
+                             "全图FFT超出预算时频谱保存在外存临时文件中，滤波预览使用分块模式");
+        
+        if (ImGui::Button("精度对比", ImVec2(-1, 0))) {
+            precisionReport = processor->comparePrecision();
+        }
+        if (precisionReport.valid) {
+            ImGui::Text("频谱相对误差: 最大 %.2e, RMS %.2e",
+                        precisionReport.spectrumMaxError, precisionReport.spectrumRmsError);
+            ImGui::Text("往返误差: 最大 %.4f, PSNR %.1f dB",
+                        precisionReport.roundtripMaxError, precisionReport.roundtripPSNR);
+            ImGui::Text("耗时: double %.2f ms, float %.2f ms",
+                        precisionReport.doubleTimeMs, precisionReport.floatTimeMs);
+        }
         
         if (processor->getGrayImage().size() > 0) {
             ImGui::Text("数据状态: 已加载");
         }
+        if (!processor->fitsFullTransform()) {
+            ImGui::TextColored(ImVec4(1, 1, 0, 1), "全图FFT超出内存预算，滤波使用分块模式");
+        }
+        if (processor->isSpectrumOutOfCore()) {
+            ImGui::Text("频谱保存在外存临时文件中: %s", processor->getScratchDirectory().c_str());
+        }
     } else {
         ImGui::Text("未加载图像");
     }
@@ -945,6 +1037,7 @@ void GUI::drawControlWindow() {
     
     if (ImGui::Button("执行FFT", ImVec2(-1, 0))) {
         if (processor->getWidth() > 0) {
+            previewWorker.cancelAndWait();
             processor->fft2D();
             updateImageTextures();
             ImGui::OpenPopup("FFT完成");
@@ -992,6 +1085,19 @@ void GUI::drawFilterWindow() {
     
     ImGui::Separator();
     
+    const char* shapeNames[] = { "理想", "高斯", "巴特沃斯", "升余弦" };
+    if (ImGui::Combo("滤波器形状", &filterShape, shapeNames, 4)) typeChanged = true;
+    ImGui::SameLine();
+    GuiUtils::helpMarker("理想滤波边缘陡峭，会产生振铃；高斯、巴特沃斯和升余弦的过渡平滑");
+    
+    if (filterShape == static_cast<int>(FilterShape::Butterworth)) {
+        if (ImGui::SliderInt("阶数", &butterworthOrder, 1, 10)) typeChanged = true;
+    } else if (filterShape == static_cast<int>(FilterShape::RaisedCosine)) {
+        if (ImGui::SliderFloat("过渡带宽", &raisedCosineRolloff, 0.05f, 1.0f, "%.2f")) typeChanged = true;
+    }
+    
+    ImGui::Separator();
+    
     bool paramChanged = false;
     
     switch (filterType) {
@@ -1028,6 +1134,21 @@ void GUI::drawFilterWindow() {
             break;
     }
     
+    ImGui::Separator();
+    
+    if (ImGui::Checkbox("附加陷波", &notchEnabled)) paramChanged = true;
+    ImGui::SameLine();
+    GuiUtils::helpMarker("在当前滤波器之外去除指定频率附近的分量（如周期性噪声），\n"
+                         "两者组合为滤波链，对频谱一次遍历后只做一次逆变换");
+    if (notchEnabled) {
+        int halfW = std::max(1, processor->getWidth() / 2);
+        int halfH = std::max(1, processor->getHeight() / 2);
+        if (ImGui::SliderInt("陷波水平频率", &notchU, -halfW, halfW)) paramChanged = true;
+        if (ImGui::SliderInt("陷波垂直频率", &notchV, -halfH, halfH)) paramChanged = true;
+        if (ImGui::SliderFloat("陷波半径", &notchRadius, 0.5f, 50.0f, "%.1f")) paramChanged = true;
+        if (ImGui::Checkbox("平滑陷波", &notchSmooth)) paramChanged = true;
+    }
+    
     if (typeChanged || paramChanged) {
         onFilterParameterChanged();
     }
@@ -1042,6 +1163,35 @@ void GUI::drawFilterWindow() {
     ImGui::SameLine();
     GuiUtils::helpMarker("启用后，参数改变时自动应用滤波器");
     
+    if (ImGui::Checkbox("分块滤波", &useTiledFilter)) {
+        onFilterParameterChanged();
+    }
+    ImGui::SameLine();
+    GuiUtils::helpMarker("把图像分成相互重叠的块分别滤波，不需要全图频谱，适合超出内存预算的大图像。\n"
+                         "截止频率很低的理想滤波在块边界处是近似的；不支持附加陷波和频带缓存");
+    
+    if (ImGui::Checkbox("频带缓存预览", &useBandCache)) {
+        // 缓存由预览任务按需构建（需要 K 次全图逆变换，不在界面线程中执行）
+        if (!useBandCache) {
+            previewWorker.cancelAndWait();
+            processor->clearBandCache();
+        }
+        onFilterParameterChanged();
+    }
+    ImGui::SameLine();
+    GuiUtils::helpMarker("预先把频谱按半径分为若干环带并分别逆变换，之后调节参数只需对环带图像加权求和。\n"
+                         "结果是近似的（截止频率落在环带边界上时精确），适合大图像拖动滑块；附加陷波时不使用");
+    if (!useBandCache) {
+        ImGui::SliderInt("环带数", &bandCacheBands, 4, 64);
+        ImGui::Text("预计内存: %.1f MB",
+                    RadialBandCache::estimateBytes(processor->getWidth(), processor->getHeight(), bandCacheBands) /
+                    (1024.0 * 1024.0));
+    } else if (!previewWorker.busy() && processor->hasBandCache()) {
+        // 缓存可能正由预览任务构建，只在预览线程空闲时读取
+        ImGui::Text("环带数: %d，内存: %.1f MB", processor->getBandCount(),
+                    processor->getBandCacheBytes() / (1024.0 * 1024.0));
+    }
+    
     if (ImGui::Button("手动应用", ImVec2(-1, 0))) {
         applyCurrentFilter();
     }
@@ -1050,6 +1200,10 @@ void GUI::drawFilterWindow() {
         resetFilter();
     }
     
+    if (previewWorker.busy()) {
+        ImGui::TextColored(ImVec4(1, 1, 0, 1), filteredPreviewLevel > 0 ? "低分辨率预览，正在细化..." : "正在计算预览...");
+    }
+    
     ImGui::Separator();
     ImGui::Text("预览效果:");
     ImGui::Text("原图 → 滤波器 → 结果图");
@@ -1101,7 +1255,7 @@ void GUI::drawStatsWindow() {
         
         ImGui::Spacing();
         
-        if (filteredImageTexture && filteredStats.mse >= 0) {
+        if (filteredDisplayTexture() && filteredStats.mse >= 0) {
             ImGui::Text("滤波后图像统计:");
             ImGui::Separator();
             
@@ -1151,6 +1305,19 @@ void GUI::drawStatsWindow() {
             ImGui::BulletText("PSNR: 峰值信噪比，越大越好 (通常>30dB为良好)");
             ImGui::BulletText("SSIM: 结构相似性，越接近1越好 (1表示完全相同)");
         }
+        
+        ImGui::Spacing();
+        if (ImGui::Button("频谱数值诊断")) {
+            spectrumDiagnostics = processor->diagnoseSpectrum(processor->getFrequencyDomain());
+            hasSpectrumDiagnostics = true;
+        }
+        if (hasSpectrumDiagnostics) {
+            ImGui::Text("系数个数: %zu (NaN: %zu, Inf: %zu)", spectrumDiagnostics.count,
+                        spectrumDiagnostics.nanCount, spectrumDiagnostics.infCount);
+            ImGui::Text("总能量: %.6e", spectrumDiagnostics.energy);
+            ImGui::Text("幅值范围: %.3e ~ %.3e, 平均 %.3e", spectrumDiagnostics.minValue,
+                        spectrumDiagnostics.maxValue, spectrumDiagnostics.meanValue);
+        }
     } else {
         ImGui::Text("请先加载图像");
         if (ImGui::Button("创建测试图像")) {
@@ -1194,7 +1361,7 @@ void GUI::drawAboutWindow() {
     ImGui::Spacing();
     ImGui::Text("使用提示:");
     ImGui::BulletText("支持 PNG, JPG, BMP 等常见格式");
-    ImGui::BulletText("图像会自动调整为2的幂次尺寸");
+    ImGui::BulletText("支持任意尺寸的图像，无需缩放");
     ImGui::BulletText("可实时调整滤波器参数查看效果");
     ImGui::BulletText("所有窗口都可独立移动和调整");
     
@@ -1214,7 +1381,7 @@ void GUI::drawFrequencyPlot() {
     int width = processor->getWidth();
     int height = processor->getHeight();
     
-    if (freqDomain.empty() || freqDomain.size() != height) {
+    if (freqDomain.empty() || freqDomain.height() != height) {
         ImGui::Text("频域数据不可用，请先执行FFT");
         return;
     }
@@ -1227,7 +1394,7 @@ void GUI::drawFrequencyPlot() {
     int centerY = height / 2;
     for (int x = 0; x < width; ++x) {
         freqX.push_back(static_cast<float>(x - width/2));
-        double mag = freqDomain[centerY][x].magnitude();
+        double mag = processor->getCenteredCoefficient(x, centerY).magnitude();
         magnitudeX.push_back(static_cast<float>(std::log(1.0 + mag)));
     }
     
@@ -1235,7 +1402,7 @@ void GUI::drawFrequencyPlot() {
     int centerX = width / 2;
     for (int y = 0; y < height; ++y) {
         freqY.push_back(static_cast<float>(y - height/2));
-        double mag = freqDomain[y][centerX].magnitude();
+        double mag = processor->getCenteredCoefficient(centerX, y).magnitude();
         magnitudeY.push_back(static_cast<float>(std::log(1.0 + mag)));
     }
     
@@ -1254,7 +1421,7 @@ void GUI::drawFrequencyPlot() {
     }
 }
 
-void GUI::drawHistogram(const std::vector<std::vector<double>>& image, const std::string& title) {
+void GUI::drawHistogram(const Image<double>& image, const std::string& title) {
     if (image.empty()) return;
     
     // 计算直方图
@@ -1265,10 +1432,11 @@ void GUI::drawHistogram(const std::vector<std::vector<double>>& image, const std
     // 找到数据范围
     double minVal = image[0][0];
     double maxVal = image[0][0];
-    for (const auto& row : image) {
-        for (double val : row) {
-            minVal = std::min(minVal, val);
-            maxVal = std::max(maxVal, val);
+    for (int y = 0; y < image.height(); ++y) {
+        const double* row = image.row(y);
+        for (int x = 0; x < image.width(); ++x) {
+            minVal = std::min(minVal, row[x]);
+            maxVal = std::max(maxVal, row[x]);
         }
     }
     
@@ -1284,9 +1452,10 @@ void GUI::drawHistogram(const std::vector<std::vector<double>>& image, const std
     }
     
     // 统计像素值
-    for (const auto& row : image) {
-        for (double val : row) {
-            int binIndex = static_cast<int>((val - minVal) / binWidth);
+    for (int y = 0; y < image.height(); ++y) {
+        const double* row = image.row(y);
+        for (int x = 0; x < image.width(); ++x) {
+            int binIndex = static_cast<int>((row[x] - minVal) / binWidth);
             binIndex = std::max(0, std::min(numBins - 1, binIndex));
             bins[binIndex] += 1.0f;
         }
@@ -1308,107 +1477,147 @@ void GUI::updateImageTextures() {
     calculateImageStats(processor->getGrayImage(), originalStats);
     
     // 创建或更新原始图像纹理
-    originalImageTexture = createTextureFromImage(processor->getGrayImage(), 
-                                                 processor->getWidth(), 
-                                                 processor->getHeight(), 
-                                                 ColorMap::GRAYSCALE);
+    updateTextureFromImage(originalImageTexture, processor->getGrayImage(),
+                           processor->getWidth(), processor->getHeight(),
+                           ColorMap::GRAYSCALE);
     
-    // 创建频域幅度和相位图像
-    const auto& freqDomain = processor->getFrequencyDomain();
+    // 创建频域幅度和相位图像（通过中心化视图逐行读取半频谱，不展开完整频谱）
+    FFT2D::CenteredSpectrumView<double> freqDomain = processor->getCenteredView();
     if (!freqDomain.empty()) {
-        std::vector<std::vector<double>> magnitudeImage(processor->getHeight(), 
-                                                        std::vector<double>(processor->getWidth()));
-        std::vector<std::vector<double>> phaseImage(processor->getHeight(), 
-                                                   std::vector<double>(processor->getWidth()));
+        Image<double> magnitudeImage(processor->getWidth(), processor->getHeight());
+        Image<double> phaseImage(processor->getWidth(), processor->getHeight());
+        std::vector<Complex> src(processor->getWidth());
         
         for (int y = 0; y < processor->getHeight(); ++y) {
+            freqDomain.row(y, src.data());
+            double* mag = magnitudeImage.row(y);
+            double* pha = phaseImage.row(y);
             for (int x = 0; x < processor->getWidth(); ++x) {
-                magnitudeImage[y][x] = std::log(1.0 + freqDomain[y][x].magnitude());
-                phaseImage[y][x] = freqDomain[y][x].phase() + M_PI; // 偏移到0-2π范围
+                mag[x] = std::log(1.0 + src[x].magnitude());
+                pha[x] = src[x].phase() + M_PI; // 偏移到0-2π范围
             }
         }
         
-        frequencyMagnitudeTexture = createTextureFromImage(magnitudeImage, 
-                                                          processor->getWidth(), 
-                                                          processor->getHeight(), 
-                                                          currentColorMap);
+        updateTextureFromImage(frequencyMagnitudeTexture, magnitudeImage,
+                               processor->getWidth(), processor->getHeight(),
+                               currentColorMap);
         
-        frequencyPhaseTexture = createTextureFromImage(phaseImage, 
-                                                      processor->getWidth(), 
-                                                      processor->getHeight(), 
-                                                      currentColorMap);
+        updateTextureFromImage(frequencyPhaseTexture, phaseImage,
+                               processor->getWidth(), processor->getHeight(),
+                               currentColorMap);
     }
     
     // 应用当前滤波器
     applyCurrentFilter();
 }
 
-GLuint GUI::createTextureFromImage(const std::vector<std::vector<double>>& image, 
-                                   int width, int height, ColorMap colorMap) {
-    if (image.empty() || width <= 0 || height <= 0) {
-        return 0;
-    }
-    
+// 按颜色映射把图像转换为RGBA数据，写入复用的 colorBuffer
+void GUI::fillColorBuffer(const Image<double>& image, int width, int height, ColorMap colorMap,
+                          std::vector<unsigned char>& buffer) {
     // 找到最大值和最小值用于归一化
     double minVal = image[0][0];
     double maxVal = image[0][0];
     
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            if (y < image.size() && x < image[y].size()) {
-                minVal = std::min(minVal, image[y][x]);
-                maxVal = std::max(maxVal, image[y][x]);
-            }
+    int validWidth = std::min(width, image.width());
+    int validHeight = std::min(height, image.height());
+    for (int y = 0; y < validHeight; ++y) {
+        const double* row = image.row(y);
+        for (int x = 0; x < validWidth; ++x) {
+            minVal = std::min(minVal, row[x]);
+            maxVal = std::max(maxVal, row[x]);
         }
     }
     
-    // 创建RGBA颜色数据
-    std::vector<unsigned char> colorData(width * height * 4);
+    // 创建RGBA颜色数据（尺寸不变时不重新分配）
+    buffer.resize(static_cast<size_t>(width) * height * 4);
     
     for (int y = 0; y < height; ++y) {
+        const double* row = (y < validHeight) ? image.row(y) : nullptr;
         for (int x = 0; x < width; ++x) {
             double value = 0.0;
-            if (y < image.size() && x < image[y].size()) {
-                value = image[y][x];
+            if (row && x < validWidth) {
+                value = row[x];
             }
             
             // 归一化值
             double normalized = (maxVal != minVal) ? (value - minVal) / (maxVal - minVal) : 0.0;
             ImVec4 color = GuiUtils::getColorFromValue(normalized, colorMap);
             
-            int idx = (y * width + x) * 4;
-            colorData[idx + 0] = static_cast<unsigned char>(color.x * 255);
-            colorData[idx + 1] = static_cast<unsigned char>(color.y * 255);
-            colorData[idx + 2] = static_cast<unsigned char>(color.z * 255);
-            colorData[idx + 3] = 255; // Alpha
+            size_t idx = (static_cast<size_t>(y) * width + x) * 4;
+            buffer[idx + 0] = static_cast<unsigned char>(color.x * 255);
+            buffer[idx + 1] = static_cast<unsigned char>(color.y * 255);
+            buffer[idx + 2] = static_cast<unsigned char>(color.z * 255);
+            buffer[idx + 3] = 255; // Alpha
         }
     }
+}
+
+GLuint GUI::createTextureFromImage(const Image<double>& image, 
+                                   int width, int height, ColorMap colorMap) {
+    if (image.empty() || width <= 0 || height <= 0) {
+        return 0;
+    }
+    
+    fillColorBuffer(image, width, height, colorMap, colorBuffer);
+    
+    GLuint textureID = 0;
+    uploadTexture(textureID, colorBuffer.data(), width, height);
+    return textureID;
+}
+
+// 尺寸不变时用 glTexSubImage2D 覆盖内容，不重新创建纹理；否则重建
+void GUI::uploadTexture(GLuint& texture, const unsigned char* rgba, int width, int height) {
+    if (texture) {
+        GLint textureWidth = 0, textureHeight = 0;
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &textureWidth);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &textureHeight);
+        if (textureWidth == width && textureHeight == height) {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            return;
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glDeleteTextures(1, &texture);
+    }
     
     // 创建OpenGL纹理
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
     
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, colorData.data());
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
     
     glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+// 更新已有纹理，尺寸不变时复用
+void GUI::updateTextureFromImage(GLuint& texture, const Image<double>& image,
+                                 int width, int height, ColorMap colorMap) {
+    if (image.empty() || width <= 0 || height <= 0) {
+        if (texture) {
+            glDeleteTextures(1, &texture);
+            texture = 0;
+        }
+        return;
+    }
     
-    return textureID;
+    fillColorBuffer(image, width, height, colorMap, colorBuffer);
+    uploadTexture(texture, colorBuffer.data(), width, height);
 }
 
-void GUI::calculateImageStats(const std::vector<std::vector<double>>& image, ImageStats& stats) {
-    if (image.empty() || image[0].empty()) {
+void GUI::calculateImageStats(const Image<double>& image, ImageStats& stats) {
+    if (image.empty()) {
         stats = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
         return;
     }
     
-    int height = image.size();
-    int width = image[0].size();
+    int height = image.height();
+    int width = image.width();
     
     stats.minValue = image[0][0];
     stats.maxValue = image[0][0];
@@ -1436,58 +1645,170 @@ void GUI::calculateImageStats(const std::vector<std::vector<double>>& image, Ima
     stats.stdValue = std::sqrt(stats.stdValue / (width * height));
 }
 
+namespace {
+
+// 逐级细化预览：第一级的较长边尺寸，以及启用逐级细化的最小图像尺寸
+constexpr int ProgressivePreviewSize = 256;
+constexpr int ProgressiveMinSize = 1024;
+
+}
+
 void GUI::applyCurrentFilter() {
     if (processor->getWidth() == 0) return;
     
-    std::vector<std::vector<Complex>> filteredFreq;
+    // 滤波和重建都在处理器的工作区中完成，拖动滑块时不分配内存
+    FilterSpec spec;
+    spec.shape = static_cast<FilterShape>(filterShape);
+    spec.order = butterworthOrder;
+    spec.rolloff = raisedCosineRolloff;
+    bool filtered = true;
     
     switch (filterType) {
         case 0: // 低通
-            filteredFreq = processor->lowPassFilter(lowPassCutoff);
+            spec.band = FilterBand::LowPass;
+            spec.cutoff = lowPassCutoff;
             break;
         case 1: // 高通
-            filteredFreq = processor->highPassFilter(highPassCutoff);
+            spec.band = FilterBand::HighPass;
+            spec.cutoff = highPassCutoff;
             break;
         case 2: // 带通
-            if (bandPassLow < bandPassHigh) {
-                filteredFreq = processor->bandPassFilter(bandPassLow, bandPassHigh);
-            } else {
-                filteredFreq = processor->getFrequencyDomain();
-            }
+            spec.band = FilterBand::BandPass;
+            spec.bandLow = bandPassLow;
+            spec.bandHigh = bandPassHigh;
+            filtered = bandPassLow < bandPassHigh;
             break;
         default:
-            filteredFreq = processor->getFrequencyDomain();
+            filtered = false;
             break;
     }
     
-    // 重建图像
-    auto filteredImage = processor->ifft2D(filteredFreq);
-    
-    // 创建滤波后图像纹理
-    if (filteredImageTexture) {
-        glDeleteTextures(1, &filteredImageTexture);
-    }
-    filteredImageTexture = createTextureFromImage(filteredImage, 
-                                                 processor->getWidth(), 
-                                                 processor->getHeight(), 
-                                                 ColorMap::GRAYSCALE);
+    // 滤波、重建、颜色映射和统计都在预览线程中完成；拖动滑块时只保留最新的参数，
+    // 界面继续显示上一次完成的结果，直到新结果在 pollFilterPreview() 中被取走
+    // 全图FFT超出内存预算时（频谱在外存中或尚未计算）使用分块滤波
+    bool tiled = useTiledFilter || !processor->fitsFullTransform() || processor->getFrequencyDomain().empty();
+    bool useNotch = notchEnabled && !tiled;
+    bool useCache = useBandCache && !tiled && !useNotch && filtered;
+    int bands = bandCacheBands;
+    int u = notchU, v = notchV;
+    double radius = notchRadius;
+    bool smooth = notchSmooth;
+    previewWorker.submit([this, spec, filtered, tiled, useNotch, useCache, bands, u, v, radius, smooth](
+                             PreviewResult& result, const PreviewWorker::Token& token) {
+        int longest = std::max(processor->getWidth(), processor->getHeight());
+        bool progressive = !tiled && longest >= ProgressiveMinSize;
+        
+        // 低分辨率预览和附加陷波都通过滤波链完成
+        if (progressive || useNotch) {
+            filterChain.clear();
+            if (filtered) {
+                filterChain.addRadial(spec);
+            }
+            if (useNotch) {
+                filterChain.addNotch(u, v, radius, smooth);
+            }
+        }
+        
+        // 大图像先在低分辨率下滤波（只取频谱中心的低频部分），每级边长乘以 4 逐级细化，
+        // 每完成一级就交给界面显示；质量指标需要与原图逐像素比较，只在原始分辨率下计算
+        int level = 0;
+        for (int size = ProgressivePreviewSize; progressive && size * 2 <= longest; size *= 4) {
+            const Image<double>& reduced = processor->reducedPreview(filterChain, size);
+            if (token.cancelled()) return false;
+            
+            result.image = reduced;
+            result.level = ++level;
+            fillColorBuffer(result.image, result.image.width(), result.image.height(),
+                            ColorMap::GRAYSCALE, result.rgba);
+            calculateImageStats(result.image, result.stats);
+            token.publish();
+            if (token.cancelled()) return false;
+        }
+        
+        if (tiled) {
+            if (!filtered) {
+                result.image = processor->getGrayImage();
+            } else if (!processor->filterTiled(spec, result.image)) {
+                return false;
+            }
+        } else {
+            // 频带缓存在重新执行FFT后失效，在预览线程中按需重建；之后的任务直接使用，
+            // 构建失败时 bandCachePreview 退回逐系数滤波
+            if (useCache && !processor->hasBandCache()) {
+                processor->buildBandCache(bands);
+                if (token.cancelled()) return false;
+            }
+            const Image<double>& filteredImage = useNotch ? processor->filterChainPreview(filterChain)
+                                               : !filtered ? processor->unfilteredPreview()
+                                               : useCache ? processor->bandCachePreview(spec)
+                                               : processor->filterPreview(spec);
+            result.image = filteredImage;
+        }
+        if (token.cancelled()) return false;
+        
+        result.level = 0;
+        fillColorBuffer(result.image, result.image.width(), result.image.height(),
+                        ColorMap::GRAYSCALE, result.rgba);
+        if (token.cancelled()) return false;
+        
+        // 计算滤波后图像统计信息
+        calculateImageStats(result.image, result.stats);
+        
+        // 计算质量指标
+        const Image<double>& original = processor->getGrayImage();
+        if (!original.empty()) {
+            result.stats.mse = processor->calculateMSE(original, result.image);
+            result.stats.psnr = processor->calculatePSNR(result.stats.mse);
+            if (token.cancelled()) return false;
+            result.stats.ssim = processor->calculateSSIM(original, result.image);
+        }
+        return true;
+    });
+}
+
+void GUI::pollFilterPreview() {
+    if (!previewWorker.poll()) return;
     
-    // 计算滤波后图像统计信息
-    calculateImageStats(filteredImage, filteredStats);
+    // GUI 线程只需上传纹理
+    const PreviewResult& result = previewWorker.result();
+    if (result.image.empty()) return;
     
-    // 计算质量指标
-    if (!processor->getGrayImage().empty()) {
-        filteredStats.mse = processor->calculateMSE(processor->getGrayImage(), filteredImage);
-        filteredStats.psnr = processor->calculatePSNR(filteredStats.mse);
-        filteredStats.ssim = processor->calculateSSIM(processor->getGrayImage(), filteredImage);
+    if (result.level > 0) {
+        // 各级低分辨率结果使用各自的纹理，尺寸固定，显示时拉伸到原图尺寸
+        if (filteredLevelTextures.size() < static_cast<size_t>(result.level)) {
+            filteredLevelTextures.resize(result.level, 0);
+        }
+        uploadTexture(filteredLevelTextures[result.level - 1], result.rgba.data(),
+                      result.image.width(), result.image.height());
+        // 质量指标保留上一次原始分辨率结果的值
+        filteredStats.meanValue = result.stats.meanValue;
+        filteredStats.stdValue = result.stats.stdValue;
+        filteredStats.minValue = result.stats.minValue;
+        filteredStats.maxValue = result.stats.maxValue;
+    } else {
+        uploadTexture(filteredImageTexture, result.rgba.data(), result.image.width(), result.image.height());
+        filteredStats = result.stats;
+    }
+    filteredPreviewLevel = result.level;
+}
+
+GLuint GUI::filteredDisplayTexture() const {
+    if (filteredPreviewLevel > 0 && static_cast<size_t>(filteredPreviewLevel) <= filteredLevelTextures.size()) {
+        return filteredLevelTextures[filteredPreviewLevel - 1];
     }
+    return filteredImageTexture;
 }
 
 void GUI::cleanup() {
+    previewWorker.cancelAndWait();
+    
     if (originalImageTexture) glDeleteTextures(1, &originalImageTexture);
     if (frequencyMagnitudeTexture) glDeleteTextures(1, &frequencyMagnitudeTexture);
     if (frequencyPhaseTexture) glDeleteTextures(1, &frequencyPhaseTexture);
     if (filteredImageTexture) glDeleteTextures(1, &filteredImageTexture);
+    for (GLuint texture : filteredLevelTextures) {
+        if (texture) glDeleteTextures(1, &texture);
+    }
 
     // 清理文件对话框
     cleanupFileDialogs();
@@ -1518,6 +1839,7 @@ void GUI::dropCallback(GLFWwindow* window, int count, const char** paths) {
     if (gui && count > 0) {
         gui->currentImagePath = paths[0];
         std::cout << "拖拽文件: " << paths[0] << std::endl;
+        gui->previewWorker.cancelAndWait();
         if (gui->processor->loadImage(paths[0])) {
             gui->processor->fft2D();
             gui->updateImageTextures();
@@ -1558,6 +1880,7 @@ bool GUI::openImageFile() {
         currentImagePath = filename;
         std::cout << "尝试加载: " << filename << std::endl;
         
+        previewWorker.cancelAndWait();
         if (processor->loadImage(filename)) {
             processor->fft2D();
             updateImageTextures();
@@ -1599,16 +1922,17 @@ bool GUI::saveCurrentImage() {
     
     try {
         // 根据当前显示模式保存相应的图像
-        std::vector<std::vector<double>> imageToSave;
+        Image<double> imageToSave;
         
         switch (currentDisplayMode) {
             case DisplayMode::ORIGINAL_IMAGE:
                 imageToSave = processor->getGrayImage();
                 break;
             case DisplayMode::FILTERED_IMAGE:
-                // 获取当前滤波后的图像
+                // 获取当前滤波后的图像（与预览线程共享处理器的工作区，先等待预览完成）
                 {
-                    std::vector<std::vector<Complex>> filteredFreq;
+                    previewWorker.waitIdle();
+                    Spectrum<Complex> filteredFreq;
                     switch (filterType) {
                         case 0: filteredFreq = processor->lowPassFilter(lowPassCutoff); break;
                         case 1: filteredFreq = processor->highPassFilter(highPassCutoff); break;
@@ -1637,6 +1961,7 @@ bool GUI::saveCurrentImage() {
 }
 
 void GUI::createTestImage() {
+    previewWorker.cancelAndWait();
     processor->createTestImage(256);
     processor->fft2D();
     updateImageTextures();
@@ -1646,10 +1971,19 @@ void GUI::createTestImage() {
 
 void GUI::resetFilter() {
     filterType = 0;
+    filterShape = 0;
+    butterworthOrder = 2;
+    raisedCosineRolloff = 0.5f;
     lowPassCutoff = 0.5f;
     highPassCutoff = 0.5f;
     bandPassLow = 0.2f;
     bandPassHigh = 0.8f;
+    notchEnabled = false;
+    notchU = 0;
+    notchV = 0;
+    notchRadius = 3.0f;
+    notchSmooth = false;
+    useTiledFilter = false;
     applyCurrentFilter();
 }
 
@@ -0,0 +1,189 @@
+#include "GrayConversion.h"
+#include "FFTKernels.h"
+#include "ThreadPool.h"
+#include <cmath>
+#include <cstdint>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #define GRAY_X86_SIMD 1
+    // GCC 12 的 gather 内联函数会误报 -Wmaybe-uninitialized
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+    #include <immintrin.h>
+    #pragma GCC diagnostic pop
+#else
+    #define GRAY_X86_SIMD 0
+#endif
+
+namespace {
+
+using Table = double[256];
+
+// sRGB 编码值 v（0..255）对应的线性光强，放大到 0..255
+double srgbToLinear(int v) {
+    double c = v / 255.0;
+    double linear = c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+    return 255.0 * linear;
+}
+
+// 标量内核：处理 [begin, width) 的像素
+template<int C>
+void rowScalar(const unsigned char* src, int begin, int width, const Table* weights, const double* single, double* dst) {
+    for (int x = begin; x < width; x++) {
+        const unsigned char* pixel = src + static_cast<size_t>(x) * C;
+        if (C >= 3) {
+            dst[x] = weights[0][pixel[0]] + weights[1][pixel[1]] + weights[2][pixel[2]];
+        } else {
+            dst[x] = single[pixel[0]];
+        }
+    }
+}
+
+#if GRAY_X86_SIMD
+
+// 第 c 个通道在 4 个像素（每像素 C 字节）中的字节，零扩展为 4 个 32 位下标
+template<int C>
+__attribute__((target("avx2")))
+inline __m128i channelIndices(int c) {
+    const char z = static_cast<char>(0x80);
+    return _mm_setr_epi8(static_cast<char>(c), z, z, z, static_cast<char>(C + c), z, z, z,
+                         static_cast<char>(2 * C + c), z, z, z, static_cast<char>(3 * C + c), z, z, z);
+}
+
+// 读取从 pixel 开始的 4 个像素，不越过这 4 个像素之后行内剩余的字节（由调用者保证）
+template<int C>
+__attribute__((target("avx2")))
+inline __m128i loadPixels(const unsigned char* pixel) {
+    if (C == 1) {
+        int bytes;
+        __builtin_memcpy(&bytes, pixel, sizeof(bytes));
+        return _mm_cvtsi32_si128(bytes);
+    }
+    if (C == 2) {
+        return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixel));
+    }
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixel));
+}
+
+// 4 个像素某一通道的灰度贡献：Lookup 时按下标 gather 查表，否则直接乘以权重
+// （Luma 模式的表项就是 权重 × v，两种方式结果逐位相同，但乘法比 gather 快）
+template<bool Lookup>
+__attribute__((target("avx2")))
+inline __m256d channelValues(const double* table, __m128i indices, __m256d coefficient) {
+    if (Lookup) {
+        return _mm256_i32gather_pd(table, indices, 8);
+    }
+    return _mm256_mul_pd(_mm256_cvtepi32_pd(indices), coefficient);
+}
+
+// 输出按 32 字节对齐时（Image 的行都是）用非临时存储：灰度图像远大于缓存，
+// 绕过缓存直接写入可以省去读取目标缓存行的带宽
+template<bool Stream>
+__attribute__((target("avx2")))
+inline void storeGray(double* dst, __m256d value) {
+    if (Stream) {
+        _mm256_stream_pd(dst, value);
+    } else {
+        _mm256_storeu_pd(dst, value);
+    }
+}
+
+// AVX2 内核：每次 4 个像素，通道字节用 pshufb 展开为 32 位下标后查表或换算。
+// 三通道一次读取 16 字节（4 个像素只用 12 字节），因此向量循环在行尾留出 2 个像素给标量内核
+template<int C, bool Stream, bool Lookup>
+__attribute__((target("avx2")))
+void rowAVX2(const unsigned char* src, int width, const Table* weights, const double* single, double* dst) {
+    const int tail = C == 3 ? 6 : 4;
+    int x = 0;
+    if (C >= 3) {
+        const __m128i r = channelIndices<C>(0);
+        const __m128i g = channelIndices<C>(1);
+        const __m128i b = channelIndices<C>(2);
+        const __m256d wr = _mm256_set1_pd(weights[0][1]);
+        const __m256d wg = _mm256_set1_pd(weights[1][1]);
+        const __m256d wb = _mm256_set1_pd(weights[2][1]);
+        for (; x + tail <= width; x += 4) {
+            __m128i pixels = loadPixels<C>(src + static_cast<size_t>(x) * C);
+            __m256d vr = channelValues<Lookup>(weights[0], _mm_shuffle_epi8(pixels, r), wr);
+            __m256d vg = channelValues<Lookup>(weights[1], _mm_shuffle_epi8(pixels, g), wg);
+            __m256d vb = channelValues<Lookup>(weights[2], _mm_shuffle_epi8(pixels, b), wb);
+            storeGray<Stream>(dst + x, _mm256_add_pd(_mm256_add_pd(vr, vg), vb));
+        }
+    } else {
+        const __m128i first = channelIndices<C>(0);
+        for (; x + tail <= width; x += 4) {
+            __m128i indices = _mm_shuffle_epi8(loadPixels<C>(src + static_cast<size_t>(x) * C), first);
+            storeGray<Stream>(dst + x, Lookup ? _mm256_i32gather_pd(single, indices, 8) : _mm256_cvtepi32_pd(indices));
+        }
+    }
+    if (Stream) {
+        _mm_sfence();
+    }
+    rowScalar<C>(src, x, width, weights, single, dst);
+}
+
+using RowKernel = void (*)(const unsigned char*, int, const Table*, const double*, double*);
+
+template<int C>
+RowKernel selectAVX2(bool stream, bool lookup) {
+    if (stream) {
+        return lookup ? rowAVX2<C, true, true> : rowAVX2<C, true, false>;
+    }
+    return lookup ? rowAVX2<C, false, true> : rowAVX2<C, false, false>;
+}
+
+#endif
+
+}
+
+GrayConverter::GrayConverter(GrayMode mode) : grayMode(mode) {
+    const bool linear = mode == GrayMode::LinearLight;
+    const double coefficients[3] = {
+        linear ? 0.2126 : 0.299,
+        linear ? 0.7152 : 0.587,
+        linear ? 0.0722 : 0.114
+    };
+    for (int v = 0; v < 256; v++) {
+        double value = linear ? srgbToLinear(v) : static_cast<double>(v);
+        for (int c = 0; c < 3; c++) {
+            weights[c][v] = coefficients[c] * value;
+        }
+        single[v] = value;
+    }
+}
+
+void GrayConverter::convertRow(const unsigned char* src, int width, int channels, double* dst) const {
+#if GRAY_X86_SIMD
+    if (FFTKernels::activeSimdLevel() >= SimdLevel::AVX2) {
+        bool stream = (reinterpret_cast<uintptr_t>(dst) & 31) == 0;
+        bool lookup = grayMode != GrayMode::Luma;
+        switch (channels) {
+            case 1: selectAVX2<1>(stream, lookup)(src, width, weights, single, dst); return;
+            case 2: selectAVX2<2>(stream, lookup)(src, width, weights, single, dst); return;
+            case 3: selectAVX2<3>(stream, lookup)(src, width, weights, single, dst); return;
+            case 4: selectAVX2<4>(stream, lookup)(src, width, weights, single, dst); return;
+            default: break;
+        }
+    }
+#endif
+    switch (channels) {
+        case 1: rowScalar<1>(src, 0, width, weights, single, dst); break;
+        case 2: rowScalar<2>(src, 0, width, weights, single, dst); break;
+        case 3: rowScalar<3>(src, 0, width, weights, single, dst); break;
+        default: rowScalar<4>(src, 0, width, weights, single, dst); break;
+    }
+}
+
+void GrayConverter::convert(const unsigned char* src, int width, int height, int channels, Image<double>& output) const {
+    output.resize(width, height);
+    size_t rowBytes = static_cast<size_t>(width) * channels;
+    ThreadPool::global().parallelFor(0, height, 0, [&](int rowBegin, int rowEnd) {
+        for (int y = rowBegin; y < rowEnd; y++) {
+            convertRow(src + y * rowBytes, width, channels, output.row(y));
+        }
+    });
+}
+
+const char* GrayConverter::modeName(GrayMode mode) {
+    return mode == GrayMode::LinearLight ? "linear light (sRGB decoded)" : "luma";
+}
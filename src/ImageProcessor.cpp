@@ -6,11 +6,19 @@
 #include "stb_image_write.h"
 
 #include "ImageProcessor.h"
+#include "ThreadPool.h"
+#include "FilterGeometry.h"
+#include "OutOfCoreFFT.h"
+#include "RowDecoder.h"
+#include "GrayConversion.h"
 #include <iostream>
 #include <cmath>
 #include <algorithm>
 #include <fstream>
 #include <filesystem>
+#include <chrono>
+#include <limits>
+#include <stdexcept>
 
 // 跨平台文件对话框
 #ifdef _WIN32
@@ -24,19 +32,79 @@
 
 const double PI = 3.14159265358979323846;
 
-ImageProcessor::ImageProcessor() : width(0), height(0), originalChannels(0) {
-    // 预分配一些合理的容量
-    grayImage.reserve(512);
-    frequencyDomain.reserve(512);
+namespace {
+
+// 分块滤波的默认参数：块尺寸为 2 的幂，每块保留中心 384×384
+constexpr int DefaultTileSize = 512;
+constexpr int DefaultTileOverlap = 64;
+
+// 镜像反射越界的下标（... 1 0 | 0 1 2 ... n-1 | n-1 n-2 ...）
+int reflectIndex(int i, int n) {
+    int period = 2 * n;
+    i %= period;
+    if (i < 0) {
+        i += period;
+    }
+    return i < n ? i : period - 1 - i;
+}
+
+// 逐元素转换图像/频谱的精度
+template<typename Dst, typename Src>
+void convertImage(const Image<Src>& input, Image<Dst>& output) {
+    output.resize(input.width(), input.height());
+    for (int y = 0; y < input.height(); y++) {
+        const Src* src = input.row(y);
+        Dst* dst = output.row(y);
+        for (int x = 0; x < input.width(); x++) {
+            dst[x] = static_cast<Dst>(src[x]);
+        }
+    }
+}
+
+const char* filterShapeName(FilterShape shape) {
+    switch (shape) {
+        case FilterShape::Gaussian: return "Gaussian";
+        case FilterShape::Butterworth: return "Butterworth";
+        case FilterShape::RaisedCosine: return "Raised-cosine";
+        default: return "Ideal";
+    }
+}
+
+const char* filterBandName(FilterBand band) {
+    switch (band) {
+        case FilterBand::HighPass: return "high-pass";
+        case FilterBand::BandPass: return "band-pass";
+        default: return "low-pass";
+    }
+}
+
+}
+
+ImageProcessor::ImageProcessor()
+    : width(0), height(0), originalChannels(0), precision(Precision::Double),
+#ifdef NDEBUG
+      validation(false),
+#else
+      validation(true),
+#endif
+      grayMode(GrayMode::Luma), memoryBudget(DefaultMemoryBudget), tileSize(DefaultTileSize), tileOverlap(DefaultTileOverlap),
+      transferMaxSquared(-1), scratchDirectory(MappedFile::defaultScratchDirectory()) {
 }
 
 ImageProcessor::~ImageProcessor() {
-    // 显式清理大型容器
-    grayImage.clear();
-    grayImage.shrink_to_fit();
-    
-    frequencyDomain.clear();
-    frequencyDomain.shrink_to_fit();
+    // 显式释放大型缓冲区
+    grayImage.release();
+    discardSpectrum();
+}
+
+void ImageProcessor::discardSpectrum() {
+    // 视图不能留到下一次变换：内存中的变换会直接写入视图所在的映射
+    if (frequencyDomain.isView()) {
+        frequencyDomain.release();
+    } else {
+        frequencyDomain.clear();
+    }
+    spectrumFile.close();
 }
 
 std::string ImageProcessor::openFileDialog() {
@@ -102,20 +170,59 @@ bool ImageProcessor::loadImage(const std::string& filename) {
     
     // 清理之前的数据
     grayImage.clear();
-    frequencyDomain.clear();
+    discardSpectrum();
+    bandCache.clear();
+    
+    // 只读映射整个文件，解码器直接读取映射的内容，省去 read 系统调用和到读缓冲区的复制；
+    // 无法映射时（管道、设备、空文件等）改用普通的缓冲读取，只有普通读取也失败时才报告映射失败的原因
+    MappedFile mapped;
+    const unsigned char* fileData = nullptr;
+    if (mapped.openReadOnly(filename)) {
+        mapped.adviseSequential(0, mapped.size());
+        fileData = static_cast<const unsigned char*>(mapped.data());
+    }
+    // stbi_*_from_memory 的长度参数为 int，更大的文件由 stb_image 自行读取
+    bool stbFromMemory = fileData && mapped.size() <= static_cast<size_t>(std::numeric_limits<int>::max());
+    int fileBytes = stbFromMemory ? static_cast<int>(mapped.size()) : 0;
+    
+    // PNG/BMP/TGA/PNM 逐行解码，每一行直接转换到灰度图像中，峰值内存接近灰度图像本身
+    std::unique_ptr<RowDecoder> decoder = fileData ? RowDecoder::open(fileData, mapped.size(), filename)
+                                                   : RowDecoder::open(filename);
+    if (decoder) {
+        return loadImageStreaming(*decoder, filename);
+    }
+    
+    // 其他格式由 stb_image 整体解码。先只读取文件头，按内存预算检查尺寸，避免解码放不下的图像
+    int fileWidth = 0, fileHeight = 0, fileChannels = 0;
+    int known = stbFromMemory ? stbi_info_from_memory(fileData, fileBytes, &fileWidth, &fileHeight, &fileChannels)
+                              : stbi_info(filename.c_str(), &fileWidth, &fileHeight, &fileChannels);
+    if (known && fileWidth > 0 && fileHeight > 0) {
+        size_t decodedBytes = static_cast<size_t>(fileWidth) * fileHeight * fileChannels;
+        size_t grayBytes = Image<double>::alignedStride(fileWidth) * static_cast<size_t>(fileHeight) * sizeof(double);
+        if (!checkMemoryBudget(decodedBytes + grayBytes, "Loading image")) {
+            std::cerr << "Image " << fileWidth << "x" << fileHeight << " is too large; raise the memory budget" << std::endl;
+            width = height = 0;
+            return false;
+        }
+    }
     
     // 使用 stb_image 加载图像
-    unsigned char* imageData = stbi_load(filename.c_str(), &width, &height, &originalChannels, 0);
+    unsigned char* imageData = stbFromMemory
+        ? stbi_load_from_memory(fileData, fileBytes, &width, &height, &originalChannels, 0)
+        : stbi_load(filename.c_str(), &width, &height, &originalChannels, 0);
     
     if (!imageData) {
         std::cerr << "Failed to load image: " << filename << std::endl;
         std::cerr << "STB Error: " << stbi_failure_reason() << std::endl;
+        if (!fileData) {
+            std::cerr << "Memory mapping: " << mapped.failureReason() << std::endl;
+        }
         width = height = 0;
         return false;
     }
     
     // 检查图像尺寸是否合理
-    if (width <= 0 || height <= 0 || width > 4096 || height > 4096) {
+    if (width <= 0 || height <= 0) {
         std::cerr << "Image dimensions out of range: " << width << "x" << height << std::endl;
         stbi_image_free(imageData);
         width = height = 0;
@@ -130,11 +237,7 @@ bool ImageProcessor::loadImage(const std::string& filename) {
         // 转换为灰度图像
         rgbToGray(imageData, width, height, originalChannels);
         
-        // 确保图像尺寸是2的幂次
-        if (!isPowerOfTwo(width) || !isPowerOfTwo(height) || width != height) {
-            std::cout << "Resizing image to power of 2 dimensions for FFT..." << std::endl;
-            resizeImageToPowerOfTwo();
-        }
+        // FFT支持任意尺寸（混合基 / Bluestein），保持原始分辨率
         
         printImageInfo();
         
@@ -152,95 +255,60 @@ bool ImageProcessor::loadImage(const std::string& filename) {
     return true;
 }
 
-void ImageProcessor::rgbToGray(unsigned char* imageData, int w, int h, int channels) {
-    grayImage.resize(h, std::vector<double>(w));
-    
-    for (int y = 0; y < h; y++) {
-        for (int x = 0; x < w; x++) {
-            int pixelIndex = (y * w + x) * channels;
-            
-            if (channels == 1) {
-                // 已经是灰度图
-                grayImage[y][x] = static_cast<double>(imageData[pixelIndex]);
-            } else if (channels >= 3) {
-                // RGB转灰度 (使用标准权重)
-                double r = static_cast<double>(imageData[pixelIndex]);
-                double g = static_cast<double>(imageData[pixelIndex + 1]);
-                double b = static_cast<double>(imageData[pixelIndex + 2]);
-                grayImage[y][x] = 0.299 * r + 0.587 * g + 0.114 * b;
-            } else {
-                // 其他情况，直接使用第一个通道
-                grayImage[y][x] = static_cast<double>(imageData[pixelIndex]);
-            }
-        }
-    }
-}
-
-bool ImageProcessor::isPowerOfTwo(int n) {
-    return n > 0 && (n & (n - 1)) == 0;
-}
-
-void ImageProcessor::resizeImageToPowerOfTwo() {
-    // 找到最接近的2的幂次，选择正方形
-    int newSize = 1;
-    int maxDim = std::max(width, height);
-    while (newSize < maxDim) {
-        newSize *= 2;
-    }
-    
-    // 限制最大尺寸避免内存问题 - 更保守的限制
-    if (newSize > 512) {  // 从1024降到512
-        newSize = 512;
-        std::cout << "Warning: Image too large, limiting to 512x512" << std::endl;
-    }
-    
-    // 检查内存分配是否安全
-    size_t requiredMemory = static_cast<size_t>(newSize) * newSize * sizeof(double);
-    if (requiredMemory > 500 * 1024 * 1024) { // 500MB限制
-        std::cerr << "Error: Image too large for processing" << std::endl;
-        return;
+bool ImageProcessor::loadImageStreaming(RowDecoder& decoder, const std::string& filename) {
+    int w = decoder.width();
+    int h = decoder.height();
+    int channels = decoder.channels();
+    // 只有灰度图像常驻，解码器只保留一两行
+    size_t grayBytes = Image<double>::alignedStride(w) * static_cast<size_t>(h) * sizeof(double);
+    if (!checkMemoryBudget(grayBytes, "Loading image")) {
+        std::cerr << "Image " << w << "x" << h << " is too large; raise the memory budget" << std::endl;
+        width = height = 0;
+        return false;
     }
     
     try {
-        std::vector<std::vector<double>> resizedImage;
-        resizedImage.reserve(newSize);
-        
-        for (int i = 0; i < newSize; i++) {
-            resizedImage.emplace_back(newSize, 0.0);
-        }
-        
-        // 使用最近邻插值调整大小
-        double scaleX = static_cast<double>(width) / newSize;
-        double scaleY = static_cast<double>(height) / newSize;
-        
-        for (int y = 0; y < newSize; y++) {
-            for (int x = 0; x < newSize; x++) {
-                int srcX = static_cast<int>(x * scaleX);
-                int srcY = static_cast<int>(y * scaleY);
-                
-                // 边界检查
-                srcX = std::clamp(srcX, 0, width - 1);
-                srcY = std::clamp(srcY, 0, height - 1);
-                
-                resizedImage[y][x] = grayImage[srcY][srcX];
+        GrayConverter converter(grayMode);
+        grayImage.resize(w, h);
+        std::vector<unsigned char> row(static_cast<size_t>(w) * channels);
+        for (int i = 0; i < h; i++) {
+            int y = 0;
+            const unsigned char* pixels = decoder.nextRowData(row.data(), y);
+            if (!pixels) {
+                std::cerr << "Failed to load image: " << filename << std::endl;
+                std::cerr << "Decoder error: " << decoder.failureReason() << std::endl;
+                grayImage.clear();
+                width = height = 0;
+                return false;
             }
+            converter.convertRow(pixels, w, channels, grayImage.row(y));
         }
-        
-        // 安全地替换原图像
-        grayImage = std::move(resizedImage);
-        width = height = newSize;
-        
-        std::cout << "Image resized to: " << newSize << "x" << newSize << std::endl;
-        
-    } catch (const std::bad_alloc& e) {
-        std::cerr << "Memory allocation failed: " << e.what() << std::endl;
-        return;
+    } catch (const std::exception& e) {
+        std::cerr << "Image processing failed: " << e.what() << std::endl;
+        grayImage.clear();
+        width = height = 0;
+        return false;
     }
+    
+    width = w;
+    height = h;
+    originalChannels = channels;
+    std::cout << "Successfully loaded: " << filename << " (streaming)" << std::endl;
+    std::cout << "Dimensions: " << width << "x" << height << std::endl;
+    std::cout << "Channels: " << originalChannels << std::endl;
+    printImageInfo();
+    return true;
+}
+
+void ImageProcessor::rgbToGray(unsigned char* imageData, int w, int h, int channels) {
+    GrayConverter(grayMode).convert(imageData, w, h, channels, grayImage);
 }
 
 void ImageProcessor::createTestImage(int size) {
     width = height = size;
-    grayImage.resize(height, std::vector<double>(width));
+    discardSpectrum();
+    bandCache.clear();
+    grayImage.resize(width, height);
     
     // 创建更复杂的测试图像
     for (int y = 0; y < height; y++) {
@@ -256,400 +324,882 @@ void ImageProcessor::createTestImage(int size) {
     std::cout << "Test image created: " << width << "x" << height << std::endl;
 }
 
-int ImageProcessor::bitReverse(int n, int bits) {
-    int result = 0;
-    for (int i = 0; i < bits; i++) {
-        result = (result << 1) | (n & 1);
-        n >>= 1;
-    }
-    return result;
-}
-
-void ImageProcessor::fft1D(std::vector<Complex>& data) {
-    int n = data.size();
-    
-    // 检查输入数据的有效性
-    for (int i = 0; i < n; i++) {
-        if (!std::isfinite(data[i].real) || !std::isfinite(data[i].imag)) {
-            std::cerr << "Warning: Invalid input data at index " << i << std::endl;
-            data[i] = Complex(0, 0);
-        }
-    }
-    
-    if (n <= 1) return;
-    
-    // 确保n是2的幂次
-    if (!isPowerOfTwo(n)) {
-        std::cerr << "Error: FFT size must be power of 2, got " << n << std::endl;
-        return;
-    }
-    
-    int bits = static_cast<int>(log2(n));
-    
-    // 位反转重排
-    for (int i = 0; i < n; i++) {
-        int j = bitReverse(i, bits);
-        if (i < j) {
-            std::swap(data[i], data[j]);
-        }
-    }
-    
-    // 蝶形运算
-    for (int len = 2; len <= n; len *= 2) {
-        double angle = -2.0 * PI / len;
-        Complex wlen(cos(angle), sin(angle));
-        
-        for (int i = 0; i < n; i += len) {
-            Complex w(1.0, 0.0);
-            for (int j = 0; j < len / 2; j++) {
-                Complex u = data[i + j];
-                Complex v = data[i + j + len / 2] * w;
-                
-                data[i + j] = u + v;
-                data[i + j + len / 2] = u - v;
-                
-                w = w * wlen;
-                
-                // 检查中间结果的数值稳定性
-                if (!std::isfinite(data[i + j].real) || !std::isfinite(data[i + j].imag) ||
-                    !std::isfinite(data[i + j + len / 2].real) || !std::isfinite(data[i + j + len / 2].imag)) {
-                    std::cerr << "Warning: Numerical instability detected in FFT" << std::endl;
-                }
-            }
-        }
-    }
-}
-
-
-void ImageProcessor::ifft1D(std::vector<Complex>& data) {
-    int n = data.size();
-    
-    // 共轭
-    for (auto& c : data) {
-        c.imag = -c.imag;
-    }
-    
-    fft1D(data);
-    
-    // 共轭并归一化
-    for (auto& c : data) {
-        c.imag = -c.imag;
-        c = c / n;
-    }
-}
-
-void ImageProcessor::fft2D() {if (grayImage.empty()) {
+void ImageProcessor::fft2D() {
+    if (grayImage.empty()) {
         std::cerr << "No image loaded for FFT processing!" << std::endl;
         return;
     }
     
     // 检查图像尺寸
-    if (width <= 0 || height <= 0 || width > 1024 || height > 1024) {
+    if (width <= 0 || height <= 0) {
         std::cerr << "Invalid image dimensions for FFT: " << width << "x" << height << std::endl;
         return;
     }
     
+    // 全图变换超出内存预算时频谱保存在外存临时文件中
+    bool outOfCore = !fitsFullTransform();
+    
     try {
-        // 清理之前的频域数据
-        frequencyDomain.clear();
-        frequencyDomain.resize(height, std::vector<Complex>(width));
-        
-        // 初始化频域数据 - 确保数据完整性
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                // 检查边界
-                if (y < grayImage.size() && x < grayImage[y].size()) {
-                    frequencyDomain[y][x] = Complex(grayImage[y][x], 0.0);
-                } else {
-                    frequencyDomain[y][x] = Complex(0.0, 0.0);
+        // 校验模式下检查一次输入，把 NaN/Inf 替换为 0
+        if (validation) {
+            size_t invalid = 0;
+            for (int y = 0; y < height; y++) {
+                double* row = grayImage.row(y);
+                for (int x = 0; x < width; x++) {
+                    if (!std::isfinite(row[x])) {
+                        row[x] = 0.0;
+                        invalid++;
+                    }
                 }
             }
+            if (invalid > 0) {
+                std::cerr << "Warning: " << invalid << " invalid input values replaced with 0" << std::endl;
+            }
         }
         
         std::cout << "开始FFT处理..." << std::endl;
-        
-        // 对每一行进行FFT
-        for (int y = 0; y < height; y++) {
-            fft1D(frequencyDomain[y]);
+        bandCache.clear();
+        if (outOfCore || isSpectrumOutOfCore()) {
+            discardSpectrum();
         }
         
-        // 对每一列进行FFT
-        for (int x = 0; x < width; x++) {
-            std::vector<Complex> column(height);
-            for (int y = 0; y < height; y++) {
-                column[y] = frequencyDomain[y][x];
+        // 实数到复数变换，只保存 W/2+1 列的半频谱
+        if (outOfCore) {
+            std::cout << "Spectrum exceeds the memory budget, using out-of-core FFT (scratch: "
+                      << scratchDirectory << ")" << std::endl;
+            auto start = std::chrono::high_resolution_clock::now();
+            if (!OutOfCoreFFT::forwardR2C(grayImage, scratchDirectory, outOfCoreWorkBytes(), spectrumFile, frequencyDomain)) {
+                std::cerr << "Out-of-core FFT failed; check free space in " << scratchDirectory << std::endl;
+                discardSpectrum();
+                return;
             }
-            fft1D(column);
-            for (int y = 0; y < height; y++) {
-                frequencyDomain[y][x] = column[y];
+            auto end = std::chrono::high_resolution_clock::now();
+            std::cout << "Out-of-core FFT took "
+                      << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+        } else {
+            forwardTransform(grayImage, frequencyDomain);
+            // 之后的预览反复做同尺寸的逆变换：在每个线程上预先建立临时缓冲区，
+            // 不依赖任务块恰好分到哪些线程，预览过程中不再分配内存
+            if (precision == Precision::Double) {
+                FFT2D::reserveScratch<double>(width, height);
+            } else {
+                FFT2D::reserveScratch<float>(width, height);
             }
         }
         
-        std::cout << "2D FFT completed successfully" << std::endl;
-
-        frequencyDomain = fftShift(frequencyDomain);
+        if (validation) {
+            NumericDiagnostics diag = diagnoseSpectrum(frequencyDomain);
+            if (diag.nanCount > 0 || diag.infCount > 0) {
+                std::cerr << "Warning: Numerical instability detected in FFT (NaN: " << diag.nanCount
+                          << ", Inf: " << diag.infCount << ")" << std::endl;
+            }
+        }
         
-        // 立即分析结果
-        analyzeFrequencySpectrum();
+        std::cout << "2D FFT completed successfully (half spectrum " 
+                  << frequencyDomain.width() << "x" << frequencyDomain.height() << ")" << std::endl;
         
     } catch (const std::exception& e) {
         std::cerr << "FFT processing failed: " << e.what() << std::endl;
-        frequencyDomain.clear();
+        discardSpectrum();
     }
 }
 
-std::vector<std::vector<double>> ImageProcessor::ifft2D(const std::vector<std::vector<Complex>>& freqData) {
+Image<double> ImageProcessor::ifft2D(const Spectrum<Complex>& freqData) {
+    Image<double> result;
+    ifft2D(freqData, result);
+    return result;
+}
+
+void ImageProcessor::ifft2D(const Spectrum<Complex>& freqData, Image<double>& result, int activeColumns) {
     if (freqData.empty()) {
         std::cerr << "Empty frequency data for IFFT!" << std::endl;
-        return std::vector<std::vector<double>>();
+        result.clear();
+        return;
     }
     
-    std::vector<std::vector<Complex>> temp = ifftShift(freqData);
+    if (freqData.width() != FFT2D::halfWidth(width) || freqData.height() != height) {
+        std::cerr << "Frequency data size mismatch for IFFT: " << freqData.width() << "x" 
+                  << freqData.height() << std::endl;
+        result.resize(width, height, 0.0);
+        return;
+    }
     
     try {
-        // 对每一行进行IFFT
-        for (int y = 0; y < height; y++) {
-            if (y < temp.size()) {
-                ifft1D(temp[y]);
-            }
-        }
+        // 复数到实数逆变换
+        inverseTransform(freqData, result, activeColumns);
         
-        // 对每一列进行IFFT
-        for (int x = 0; x < width; x++) {
-            std::vector<Complex> column(height);
-            for (int y = 0; y < height; y++) {
-                if (y < temp.size() && x < temp[y].size()) {
-                    column[y] = temp[y][x];
-                }
-            }
-            ifft1D(column);
-            for (int y = 0; y < height; y++) {
-                if (y < temp.size() && x < temp[y].size()) {
-                    temp[y][x] = column[y];
-                }
-            }
+        if (validation) {
+            NumericDiagnostics diag = diagnoseImage(result);
+            std::cout << "IFFT result - Min: " << diag.minValue 
+                      << ", Max: " << diag.maxValue 
+                      << ", Mean: " << diag.meanValue
+                      << ", NaN: " << diag.nanCount << ", Inf: " << diag.infCount << std::endl;
         }
         
-        // 提取实部并正确处理幅度
-        std::vector<std::vector<double>> result(height, std::vector<double>(width));
-        
-        // 计算结果的统计信息用于调试
-        double minVal = 1e9, maxVal = -1e9, sum = 0;
-        int count = 0;
+        // 值域明显异常时（很少发生）重新计算并按值域线性映射到 [0, 255]
+        double minVal = 0.0, maxVal = 0.0;
+        if (clampReconstruction(result, minVal, maxVal)) {
+            std::cout << "Renormalizing IFFT result..." << std::endl;
+            inverseTransform(freqData, result, activeColumns);
+            renormalizeReconstruction(result, minVal, maxVal);
+        }
         
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                if (y < temp.size() && x < temp[y].size()) {
-                    double realPart = temp[y][x].real;
-                    
-                    // 检查数值有效性
-                    if (std::isfinite(realPart)) {
-                        minVal = std::min(minVal, realPart);
-                        maxVal = std::max(maxVal, realPart);
-                        sum += realPart;
-                        count++;
-                        
-                        // 将值限制在合理范围内
-                        result[y][x] = std::max(0.0, std::min(255.0, realPart));
-                    } else {
-                        result[y][x] = 0.0;
-                    }
+    } catch (const std::exception& e) {
+        std::cerr << "IFFT processing failed: " << e.what() << std::endl;
+        result.resize(width, height, 0.0);
+    }
+}
+
+bool ImageProcessor::clampReconstruction(Image<double>& result, double& minVal, double& maxVal) const {
+    // 限制到 [0, 255]，同时记录原始值域；NaN 的比较结果为 false，会被置为 0
+    minVal = maxVal = 0.0;
+    bool first = true;
+    for (int y = 0; y < result.height(); y++) {
+        double* row = result.row(y);
+        for (int x = 0; x < result.width(); x++) {
+            double v = row[x];
+            if (std::isfinite(v)) {
+                if (first) {
+                    minVal = maxVal = v;
+                    first = false;
                 } else {
-                    result[y][x] = 0.0;
+                    minVal = v < minVal ? v : minVal;
+                    maxVal = v > maxVal ? v : maxVal;
                 }
             }
+            row[x] = v > 0.0 ? (v < 255.0 ? v : 255.0) : 0.0;
         }
-        
-        if (count > 0) {
-            double mean = sum / count;
-            std::cout << "IFFT result - Min: " << minVal 
-                      << ", Max: " << maxVal 
-                      << ", Mean: " << mean << std::endl;
-            
-            // 如果值域不在正常范围内，进行重新归一化
-            if (maxVal > 1000 || minVal < -100) {
-                std::cout << "Renormalizing IFFT result..." << std::endl;
-                for (int y = 0; y < height; y++) {
-                    for (int x = 0; x < width; x++) {
-                        if (y < temp.size() && x < temp[y].size()) {
-                            double normalizedVal = (temp[y][x].real - minVal) / (maxVal - minVal) * 255.0;
-                            result[y][x] = std::max(0.0, std::min(255.0, normalizedVal));
-                        }
-                    }
-                }
+    }
+    return !first && (maxVal > 1000 || minVal < -100);
+}
+
+void ImageProcessor::renormalizeReconstruction(Image<double>& result, double minVal, double maxVal) const {
+    double range = maxVal - minVal;
+    for (int y = 0; y < result.height(); y++) {
+        double* row = result.row(y);
+        for (int x = 0; x < result.width(); x++) {
+            double v = (row[x] - minVal) / range * 255.0;
+            row[x] = v > 0.0 ? (v < 255.0 ? v : 255.0) : 0.0;
+        }
+    }
+}
+
+void ImageProcessor::forwardTransform(const Image<double>& input, Spectrum<Complex>& output) {
+    if (precision == Precision::Double) {
+        FFT2D::forwardR2C(input, output);
+        return;
+    }
+
+    convertImage(input, imageWorkF);
+    FFT2D::forwardR2C(imageWorkF, spectrumWorkF);
+    convertImage(spectrumWorkF, output);
+}
+
+void ImageProcessor::inverseTransform(const Spectrum<Complex>& input, Image<double>& output, int activeColumns) {
+    // 逆变换工作区超出内存预算时改用外存变换（只有双精度）
+    if (!fitsFullTransform()) {
+        if (!OutOfCoreFFT::inverseC2R(input, width, scratchDirectory, outOfCoreWorkBytes(), output, activeColumns)) {
+            throw std::runtime_error("out-of-core IFFT failed");
+        }
+        return;
+    }
+    if (precision == Precision::Double) {
+        FFT2D::inverseC2R(input, width, output, inverseWork, activeColumns);
+        return;
+    }
+
+    convertImage(input, spectrumWorkF);
+    FFT2D::inverseC2R(spectrumWorkF, width, imageWorkF, inverseWorkF, activeColumns);
+    convertImage(imageWorkF, output);
+}
+
+double ImageProcessor::cutoffRadius(double cutoffRatio) const {
+    return sqrt(width * width + height * height) / 2.0 * cutoffRatio;
+}
+
+const RadialTransferLUT& ImageProcessor::transferTable(const FilterSpec& spec) {
+    // 需要覆盖的最大 d²：整幅频谱上 kx <= W/2、|dy| <= H/2（整数除法）；分块滤波把块频率
+    // 按 W/T、H/T 换算到原图，偶数块尺寸的 kx、|ky| 可达 W/2.0、H/2.0，奇数尺寸时更大
+    double halfW = width / 2.0;
+    double halfH = height / 2.0;
+    long long maxSquared = std::llround(halfW * halfW + halfH * halfH);
+    if (spec != transferSpec || maxSquared != transferMaxSquared) {
+        transferLUT.build(spec, cutoffRadius(1.0), maxSquared);
+        transferSpec = spec;
+        transferMaxSquared = maxSquared;
+    }
+    return transferLUT;
+}
+
+bool ImageProcessor::checkMemoryBudget(size_t bytes, const char* what) const {
+    if (bytes <= memoryBudget) {
+        return true;
+    }
+    const double MB = 1024.0 * 1024.0;
+    std::cerr << what << " needs " << bytes / MB << " MB, which exceeds the memory budget of "
+              << memoryBudget / MB << " MB" << std::endl;
+    return false;
+}
+
+size_t ImageProcessor::outOfCoreWorkBytes() const {
+    // 灰度图像和逆变换的结果图像常驻内存，剩余部分由条带缓冲区和映射中正在访问的页面分摊
+    size_t resident = 2 * Image<double>::alignedStride(width) * static_cast<size_t>(height) * sizeof(double);
+    return memoryBudget > resident ? (memoryBudget - resident) / 2 : 0;
+}
+
+size_t ImageProcessor::estimateTransformBytes(int w, int h) const {
+    size_t pixels = Image<double>::alignedStride(w) * static_cast<size_t>(h);
+    size_t coefficients = Spectrum<Complex>::alignedStride(FFT2D::halfWidth(w)) * static_cast<size_t>(h);
+    // 灰度图和预览图像；频谱、逆变换工作区和预览频谱；fft2D 在每个线程上预留的变换缓冲区
+    size_t threads = static_cast<size_t>(getThreadCount());
+    size_t bytes = 2 * pixels * sizeof(double) + 3 * coefficients * sizeof(Complex) +
+                   threads * FFT2D::scratchBytes<double>(w, h);
+    if (precision == Precision::Float) {
+        // 单精度路径的频谱、逆变换工作区、图像和变换缓冲区
+        bytes += 2 * Spectrum<ComplexF>::alignedStride(FFT2D::halfWidth(w)) * static_cast<size_t>(h) * sizeof(ComplexF) +
+                 Image<float>::alignedStride(w) * static_cast<size_t>(h) * sizeof(float) +
+                 threads * FFT2D::scratchBytes<float>(w, h);
+    }
+    return bytes;
+}
+
+int ImageProcessor::columnsWithinRadius(double radius) const {
+    // 直流所在的第 0 行最宽
+    return FilterGeometry::get(width, height)->columnsWithin(0, FilterGeometry::squaredRadiusAtMost(radius));
+}
+
+NumericDiagnostics ImageProcessor::diagnoseImage(const Image<double>& image) const {
+    NumericDiagnostics diag;
+    double sum = 0.0;
+    bool first = true;
+    for (int y = 0; y < image.height(); y++) {
+        const double* row = image.row(y);
+        for (int x = 0; x < image.width(); x++) {
+            double v = row[x];
+            diag.count++;
+            if (std::isnan(v)) {
+                diag.nanCount++;
+                continue;
+            }
+            if (std::isinf(v)) {
+                diag.infCount++;
+                continue;
+            }
+            diag.energy += v * v;
+            sum += v;
+            if (first) {
+                diag.minValue = diag.maxValue = v;
+                first = false;
+            } else {
+                diag.minValue = std::min(diag.minValue, v);
+                diag.maxValue = std::max(diag.maxValue, v);
             }
         }
-        
-        return result;
-        
+    }
+    size_t finite = diag.count - diag.nanCount - diag.infCount;
+    diag.meanValue = finite > 0 ? sum / finite : 0.0;
+    return diag;
+}
+
+NumericDiagnostics ImageProcessor::diagnoseSpectrum(const Spectrum<Complex>& spectrum) const {
+    NumericDiagnostics diag;
+    double sum = 0.0;
+    bool first = true;
+    for (int y = 0; y < spectrum.height(); y++) {
+        const Complex* row = spectrum.row(y);
+        for (int x = 0; x < spectrum.width(); x++) {
+            const Complex& c = row[x];
+            diag.count++;
+            if (std::isnan(c.real) || std::isnan(c.imag)) {
+                diag.nanCount++;
+                continue;
+            }
+            if (std::isinf(c.real) || std::isinf(c.imag)) {
+                diag.infCount++;
+                continue;
+            }
+            double magnitude = c.magnitude();
+            // 除直流列（及偶数宽度的奈奎斯特列）外，每个系数代表一对共轭对称分量
+            bool selfConjugate = (x == 0) || (width % 2 == 0 && x == width / 2);
+            diag.energy += (selfConjugate ? 1.0 : 2.0) * magnitude * magnitude;
+            sum += magnitude;
+            if (first) {
+                diag.minValue = diag.maxValue = magnitude;
+                first = false;
+            } else {
+                diag.minValue = std::min(diag.minValue, magnitude);
+                diag.maxValue = std::max(diag.maxValue, magnitude);
+            }
+        }
+    }
+    size_t finite = diag.count - diag.nanCount - diag.infCount;
+    diag.meanValue = finite > 0 ? sum / finite : 0.0;
+    return diag;
+}
+
+PrecisionReport ImageProcessor::comparePrecision() const {
+    PrecisionReport report;
+    if (grayImage.empty()) {
+        std::cerr << "No image loaded for precision comparison!" << std::endl;
+        return report;
+    }
+
+    try {
+        using Clock = std::chrono::steady_clock;
+
+        // 双精度作为参考
+        auto start = Clock::now();
+        Spectrum<Complex> spectrumD;
+        Image<double> roundtripD;
+        FFT2D::forwardR2C(grayImage, spectrumD);
+        FFT2D::inverseC2R(spectrumD, width, roundtripD);
+        report.doubleTimeMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        Image<float> imageF;
+        convertImage(grayImage, imageF);
+        start = Clock::now();
+        Spectrum<ComplexF> spectrumF;
+        Image<float> roundtripF;
+        FFT2D::forwardR2C(imageF, spectrumF);
+        FFT2D::inverseC2R(spectrumF, width, roundtripF);
+        report.floatTimeMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        // 频谱误差，相对于双精度频谱的幅值
+        double maxMagnitude = 0.0, maxError = 0.0;
+        double energy = 0.0, errorEnergy = 0.0;
+        for (int y = 0; y < spectrumD.height(); y++) {
+            const Complex* d = spectrumD.row(y);
+            const ComplexF* f = spectrumF.row(y);
+            for (int x = 0; x < spectrumD.width(); x++) {
+                double er = d[x].real - f[x].real;
+                double ei = d[x].imag - f[x].imag;
+                double error2 = er * er + ei * ei;
+                double magnitude2 = d[x].real * d[x].real + d[x].imag * d[x].imag;
+                maxMagnitude = std::max(maxMagnitude, magnitude2);
+                maxError = std::max(maxError, error2);
+                energy += magnitude2;
+                errorEnergy += error2;
+            }
+        }
+        report.spectrumMaxError = maxMagnitude > 0 ? std::sqrt(maxError / maxMagnitude) : 0.0;
+        report.spectrumRmsError = energy > 0 ? std::sqrt(errorEnergy / energy) : 0.0;
+
+        // 正逆变换后的像素误差
+        double squaredError = 0.0;
+        for (int y = 0; y < height; y++) {
+            const double* original = grayImage.row(y);
+            const float* restored = roundtripF.row(y);
+            for (int x = 0; x < width; x++) {
+                double diff = original[x] - restored[x];
+                report.roundtripMaxError = std::max(report.roundtripMaxError, std::abs(diff));
+                squaredError += diff * diff;
+            }
+        }
+        double mse = squaredError / (static_cast<double>(width) * height);
+        report.roundtripPSNR = mse > 0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : 100.0;
+        report.valid = true;
+
+        std::cout << "\n=== 精度对比 (float vs double) ===" << std::endl;
+        std::cout << "频谱最大相对误差: " << report.spectrumMaxError << std::endl;
+        std::cout << "频谱RMS相对误差: " << report.spectrumRmsError << std::endl;
+        std::cout << "往返最大像素误差: " << report.roundtripMaxError << std::endl;
+        std::cout << "往返PSNR: " << report.roundtripPSNR << " dB" << std::endl;
+        std::cout << "耗时 double: " << report.doubleTimeMs << " ms, float: " << report.floatTimeMs << " ms" << std::endl;
+
     } catch (const std::exception& e) {
-        std::cerr << "IFFT processing failed: " << e.what() << std::endl;
-        return std::vector<std::vector<double>>(height, std::vector<double>(width, 0.0));
+        std::cerr << "Precision comparison failed: " << e.what() << std::endl;
+        report.valid = false;
     }
+
+    return report;
 }
 
+Spectrum<Complex> ImageProcessor::lowPassFilter(double cutoffRatio) {
+    Spectrum<Complex> filtered;
+    lowPassFilter(cutoffRatio, filtered);
+    return filtered;
+}
 
-std::vector<std::vector<Complex>> ImageProcessor::lowPassFilter(double cutoffRatio) {
+void ImageProcessor::lowPassFilter(double cutoffRatio, Spectrum<Complex>& filtered) {
     if (frequencyDomain.empty()) {
         std::cerr << "No frequency domain data available for filtering!" << std::endl;
-        return std::vector<std::vector<Complex>>();
+        filtered.clear();
+        return;
     }
     
-    std::vector<std::vector<Complex>> filtered = frequencyDomain;
+    double maxRadius = cutoffRadius(cutoffRatio);
     
-    int centerX = width / 2;
-    int centerY = height / 2;
-    double maxRadius = sqrt(width * width + height * height) / 2.0 * cutoffRatio;
+    if (validation) {
+        std::cout << "Low-pass filter: cutoff=" << cutoffRatio 
+                  << ", radius=" << maxRadius << std::endl;
+    }
+    
+    // (kx, ky) 到直流分量的距离与中心化频谱中到中心的距离相同；距离超过截止半径的分量置零
+    FilterGeometry::get(width, height)->select(frequencyDomain, filtered, -1,
+                                               FilterGeometry::squaredRadiusAtMost(maxRadius));
+}
+
+Spectrum<Complex> ImageProcessor::highPassFilter(double cutoffRatio) {
+    Spectrum<Complex> filtered;
+    highPassFilter(cutoffRatio, filtered);
+    return filtered;
+}
+
+void ImageProcessor::highPassFilter(double cutoffRatio, Spectrum<Complex>& filtered) {
+    if (frequencyDomain.empty()) {
+        std::cerr << "No frequency domain data available for filtering!" << std::endl;
+        filtered.clear();
+        return;
+    }
     
-    std::cout << "Low-pass filter: cutoff=" << cutoffRatio 
-              << ", radius=" << maxRadius 
-              << ", center=(" << centerX << "," << centerY << ")" << std::endl;
+    double minRadius = cutoffRadius(cutoffRatio);
     
-    // 遍历整个频域
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            // 计算到频域中心的距离，考虑FFT的周期性
-            
-            double dx = double(x) - centerX;
-            double dy = double(y) - centerY;
-            double distance = sqrt(dx * dx + dy * dy);
-            
-            // 如果距离超过截止半径，则将该频率分量置零
-            if (distance > maxRadius) {
-                filtered[y][x] = Complex(0, 0);
-            }
-        }
+    if (validation) {
+        std::cout << "High-pass filter: cutoff=" << cutoffRatio 
+                  << ", radius=" << minRadius << std::endl;
     }
     
+    // 距离小于截止半径的分量置零
+    FilterGeometry::get(width, height)->select(frequencyDomain, filtered,
+                                               FilterGeometry::squaredRadiusBelow(minRadius),
+                                               std::numeric_limits<long long>::max());
+}
+
+Spectrum<Complex> ImageProcessor::bandPassFilter(double lowCutoff, double highCutoff) {
+    Spectrum<Complex> filtered;
+    bandPassFilter(lowCutoff, highCutoff, filtered);
     return filtered;
 }
 
-std::vector<std::vector<Complex>> ImageProcessor::highPassFilter(double cutoffRatio) {
+void ImageProcessor::bandPassFilter(double lowCutoff, double highCutoff, Spectrum<Complex>& filtered) {
     if (frequencyDomain.empty()) {
         std::cerr << "No frequency domain data available for filtering!" << std::endl;
-        return std::vector<std::vector<Complex>>();
+        filtered.clear();
+        return;
     }
     
-    std::vector<std::vector<Complex>> filtered = frequencyDomain;
-    
-    int centerX = width / 2;
-    int centerY = height / 2;
-    double minRadius = sqrt(width * width + height * height) / 2.0 * cutoffRatio;
+    double minRadius = cutoffRadius(lowCutoff);
+    double maxRadius = cutoffRadius(highCutoff);
     
-    std::cout << "High-pass filter: cutoff=" << cutoffRatio 
-              << ", radius=" << minRadius 
-              << ", center=(" << centerX << "," << centerY << ")" << std::endl;
+    if (validation) {
+        std::cout << "Band-pass filter: low=" << lowCutoff 
+                  << ", high=" << highCutoff 
+                  << ", radius range=[" << minRadius << "," << maxRadius << "]" << std::endl;
+    }
     
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            
-            double dx = double(x) - centerX;
-            double dy = double(y) - centerY;
-            double distance = sqrt(dx * dx + dy * dy);
-            
-            // 如果距离小于截止半径，则将该频率分量置零
-            if (distance < minRadius) {
-                filtered[y][x] = Complex(0, 0);
-            }
+    // 保留在指定频率范围内的分量
+    FilterGeometry::get(width, height)->select(frequencyDomain, filtered,
+                                               FilterGeometry::squaredRadiusBelow(minRadius),
+                                               FilterGeometry::squaredRadiusAtMost(maxRadius));
+}
+
+void ImageProcessor::applyFilter(const FilterSpec& spec, Spectrum<Complex>& filtered) {
+    if (spec.shape == FilterShape::Ideal) {
+        switch (spec.band) {
+            case FilterBand::HighPass: highPassFilter(spec.cutoff, filtered); return;
+            case FilterBand::BandPass: bandPassFilter(spec.bandLow, spec.bandHigh, filtered); return;
+            default: lowPassFilter(spec.cutoff, filtered); return;
         }
     }
     
-    return filtered;
+    if (frequencyDomain.empty()) {
+        std::cerr << "No frequency domain data available for filtering!" << std::endl;
+        filtered.clear();
+        return;
+    }
+    
+    if (validation) {
+        std::cout << filterShapeName(spec.shape) << " " << filterBandName(spec.band) << " filter: cutoff="
+                  << spec.cutoff << ", band=[" << spec.bandLow << "," << spec.bandHigh << "]"
+                  << ", order=" << spec.order << ", rolloff=" << spec.rolloff << std::endl;
+    }
+    
+    // 传递函数只依赖 d²，逐系数查表相乘；支撑范围之外的尾部直接置零
+    const RadialTransferLUT& lut = transferTable(spec);
+    const FilterGeometry& geometry = *FilterGeometry::get(width, height);
+    int half = frequencyDomain.width();
+    filtered.resize(half, height);
+    ThreadPool::global().parallelFor(0, height, 0, [&](int yBegin, int yEnd) {
+        for (int y = yBegin; y < yEnd; y++) {
+            const Complex* in = frequencyDomain.row(y);
+            Complex* out = filtered.row(y);
+            long long dy2 = geometry.rowOffsetSquared(y);
+            int end = geometry.columnsWithin(y, lut.supportSquared());
+            for (int x = 0; x < end; x++) {
+                double gain = lut(static_cast<long long>(x) * x + dy2);
+                out[x] = Complex(in[x].real * gain, in[x].imag * gain);
+            }
+            std::fill(out + end, out + half, Complex());
+        }
+    });
 }
 
-std::vector<std::vector<Complex>> ImageProcessor::bandPassFilter(double lowCutoff, double highCutoff) {
+int ImageProcessor::applyFilterChain(FilterChain& chain, Spectrum<Complex>& filtered) {
     if (frequencyDomain.empty()) {
         std::cerr << "No frequency domain data available for filtering!" << std::endl;
-        return std::vector<std::vector<Complex>>();
+        filtered.clear();
+        return 0;
     }
     
-    std::vector<std::vector<Complex>> filtered = frequencyDomain;
+    if (validation) {
+        std::cout << "Filter chain: " << chain.stageCount() << " stages" << std::endl;
+    }
     
-    int centerX = width / 2;
-    int centerY = height / 2;
-    double minRadius = sqrt(width * width + height * height) / 2.0 * lowCutoff;
-    double maxRadius = sqrt(width * width + height * height) / 2.0 * highCutoff;
+    return chain.apply(frequencyDomain, width, cutoffRadius(1.0), filtered);
+}
+
+const Image<double>& ImageProcessor::lowPassPreview(double cutoffRatio) {
+    if (!fitsFullTransform()) {
+        FilterSpec spec;
+        spec.band = FilterBand::LowPass;
+        spec.cutoff = cutoffRatio;
+        return filterPreview(spec);
+    }
+    lowPassFilter(cutoffRatio, previewSpectrum);
+    // 截止半径之外的列全为零，逆变换只需处理半径以内的列
+    ifft2D(previewSpectrum, previewImage, columnsWithinRadius(cutoffRadius(cutoffRatio)));
+    return previewImage;
+}
+
+const Image<double>& ImageProcessor::highPassPreview(double cutoffRatio) {
+    if (!fitsFullTransform()) {
+        FilterSpec spec;
+        spec.band = FilterBand::HighPass;
+        spec.cutoff = cutoffRatio;
+        return filterPreview(spec);
+    }
+    highPassFilter(cutoffRatio, previewSpectrum);
+    ifft2D(previewSpectrum, previewImage);
+    return previewImage;
+}
+
+const Image<double>& ImageProcessor::bandPassPreview(double lowCutoff, double highCutoff) {
+    if (!fitsFullTransform()) {
+        FilterSpec spec;
+        spec.band = FilterBand::BandPass;
+        spec.bandLow = lowCutoff;
+        spec.bandHigh = highCutoff;
+        return filterPreview(spec);
+    }
+    bandPassFilter(lowCutoff, highCutoff, previewSpectrum);
+    ifft2D(previewSpectrum, previewImage, columnsWithinRadius(cutoffRadius(highCutoff)));
+    return previewImage;
+}
+
+const Image<double>& ImageProcessor::filterChainPreview(FilterChain& chain) {
+    // 滤波链需要全尺寸的预览频谱，超出内存预算时不分配
+    if (!fitsFullTransform()) {
+        std::cerr << "Filter chain preview needs the full in-core spectrum, which exceeds the memory budget; "
+                  << "use tiled filtering instead" << std::endl;
+        previewImage.clear();
+        return previewImage;
+    }
+    // 全部阶段合并为一次遍历，之后只做一次逆变换
+    int columns = applyFilterChain(chain, previewSpectrum);
+    ifft2D(previewSpectrum, previewImage, columns);
+    return previewImage;
+}
+
+const Image<double>& ImageProcessor::reducedPreview(FilterChain& chain, int maxSize) {
+    if (frequencyDomain.empty() || maxSize <= 0) {
+        std::cerr << "No frequency domain data available for filtering!" << std::endl;
+        reducedImage.clear();
+        return reducedImage;
+    }
     
-    std::cout << "Band-pass filter: low=" << lowCutoff 
-              << ", high=" << highCutoff 
-              << ", radius range=[" << minRadius << "," << maxRadius << "]" << std::endl;
+    // 保持宽高比，较长边不超过 maxSize
+    double factor = std::max(1.0, static_cast<double>(std::max(width, height)) / maxSize);
+    int w = std::min(width, std::max(1, static_cast<int>(std::lround(width / factor))));
+    int h = std::min(height, std::max(1, static_cast<int>(std::lround(height / factor))));
+    int half = FFT2D::halfWidth(w);
     
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            
-            double dx = double(x) - centerX;
-            double dy = double(y) - centerY;
-            double distance = sqrt(dx * dx + dy * dy);
-            
-            // 保留在指定频率范围内的分量
-            if (distance < minRadius || distance > maxRadius) {
-                filtered[y][x] = Complex(0, 0);
+    try {
+        // 截取 |kx| <= w/2、|dy| <= h/2 的系数。逆变换的归一化因子由 1/(WH) 变为 1/(wh)，
+        // 复制时乘以 wh/(WH) 补偿；被截断方向上偶数尺寸的奈奎斯特行/列没有共轭对应项，置零
+        double amplitude = static_cast<double>(w) * h / (static_cast<double>(width) * height);
+        int nyquistColumn = (w < width && w % 2 == 0) ? w / 2 : -1;
+        reducedSpectrum.resize(half, h);
+        for (int y = 0; y < h; y++) {
+            int dy = FFT2D::centeredOffset(y, h);
+            Complex* out = reducedSpectrum.row(y);
+            if (h < height && h % 2 == 0 && dy == -h / 2) {
+                std::fill(out, out + half, Complex());
+                continue;
+            }
+            const Complex* in = frequencyDomain.row(dy >= 0 ? dy : height + dy);
+            for (int x = 0; x < half; x++) {
+                out[x] = Complex(in[x].real * amplitude, in[x].imag * amplitude);
+            }
+            if (nyquistColumn >= 0) {
+                out[nyquistColumn] = Complex();
             }
         }
+        
+        int columns = chain.apply(reducedSpectrum, w, cutoffRadius(1.0), reducedFiltered);
+        FFT2D::inverseC2R(reducedFiltered, w, reducedImage, reducedWork, columns);
+        
+        double minVal = 0.0, maxVal = 0.0;
+        if (clampReconstruction(reducedImage, minVal, maxVal)) {
+            FFT2D::inverseC2R(reducedFiltered, w, reducedImage, reducedWork, columns);
+            renormalizeReconstruction(reducedImage, minVal, maxVal);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Reduced preview failed: " << e.what() << std::endl;
+        reducedImage.resize(w, h, 0.0);
+    }
+    return reducedImage;
+}
+
+const Image<double>& ImageProcessor::unfilteredPreview() {
+    // 超出内存预算时不做外存逆变换：未滤波的重建就是灰度图本身（与分块滤波模式下的界面一致）
+    if (!fitsFullTransform()) {
+        previewImage = grayImage;
+        return previewImage;
+    }
+    ifft2D(frequencyDomain, previewImage);
+    return previewImage;
+}
+
+const Image<double>& ImageProcessor::filterPreview(const FilterSpec& spec) {
+    // 全图变换超出内存预算时（频谱在外存中）不分配全尺寸的预览频谱，改用分块滤波；
+    // 分块滤波同样超出预算时返回空图像
+    if (!fitsFullTransform()) {
+        filterTiled(spec, previewImage);
+        return previewImage;
+    }
+    
+    if (spec.shape == FilterShape::Ideal) {
+        switch (spec.band) {
+            case FilterBand::HighPass: return highPassPreview(spec.cutoff);
+            case FilterBand::BandPass: return bandPassPreview(spec.bandLow, spec.bandHigh);
+            default: return lowPassPreview(spec.cutoff);
+        }
     }
     
-    return filtered;
+    applyFilter(spec, previewSpectrum);
+    // 传递函数支撑范围之外的列全为零，逆变换时跳过
+    int columns = -1;
+    if (!frequencyDomain.empty()) {
+        columns = FilterGeometry::get(width, height)->columnsWithin(0, transferLUT.supportSquared());
+    }
+    ifft2D(previewSpectrum, previewImage, columns);
+    return previewImage;
 }
 
-std::vector<std::vector<Complex>> ImageProcessor::lowPassFilterCentered(double cutoffRatio) {
-    if (frequencyDomain.empty()) {
-        std::cerr << "No frequency domain data available for filtering!" << std::endl;
-        return std::vector<std::vector<Complex>>();
+bool ImageProcessor::buildBandCache(int bands) {
+    if (frequencyDomain.empty() || bands <= 0) {
+        std::cerr << "No frequency domain data available for band cache!" << std::endl;
+        bandCache.clear();
+        return false;
     }
     
-    // 先进行FFT移位，将低频移到中心
-    auto centeredFreq = fftShift(frequencyDomain);
+    bandCache.clear();
+    // 全图变换的常驻内存、K 幅环带图像，以及构建时各并行任务的环带频谱、逆变换工作区和图像
+    size_t bytes = estimateTransformBytes(width, height) + RadialBandCache::estimateBytes(width, height, bands) +
+                   RadialBandCache::buildWorkBytes(width, height, bands, getThreadCount());
+    if (!checkMemoryBudget(bytes, "Band cache")) {
+        return false;
+    }
     
-    int centerX = width / 2;
-    int centerY = height / 2;
-    double maxRadius = std::min(width, height) / 2.0 * cutoffRatio;
+    try {
+        using Clock = std::chrono::steady_clock;
+        auto start = Clock::now();
+        bandCache.build(frequencyDomain, width, bands, cutoffRadius(1.0));
+        std::cout << "Band cache built: " << bands << " bands, "
+                  << bandCache.memoryBytes() / (1024.0 * 1024.0) << " MB, "
+                  << std::chrono::duration<double, std::milli>(Clock::now() - start).count() << " ms" << std::endl;
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Band cache construction failed: " << e.what() << std::endl;
+        bandCache.clear();
+        return false;
+    }
+}
+
+const Image<double>& ImageProcessor::bandCachePreview(const FilterSpec& spec) {
+    if (bandCache.empty()) {
+        return filterPreview(spec);
+    }
     
-    // 在中心化的频域中应用滤波
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            double dx = x - centerX;
-            double dy = y - centerY;
-            double distance = sqrt(dx * dx + dy * dy);
-            
-            if (distance > maxRadius) {
-                centeredFreq[y][x] = Complex(0, 0);
+    bandCache.compose(spec, previewImage);
+    double minVal = 0.0, maxVal = 0.0;
+    if (clampReconstruction(previewImage, minVal, maxVal)) {
+        bandCache.compose(spec, previewImage);
+        renormalizeReconstruction(previewImage, minVal, maxVal);
+    }
+    return previewImage;
+}
+
+void ImageProcessor::setTileSize(int size, int overlap) {
+    if (size <= 0 || overlap < 0 || size <= 2 * overlap) {
+        std::cerr << "Invalid tile size: " << size << " (overlap " << overlap << ")" << std::endl;
+        return;
+    }
+    tileSize = size;
+    tileOverlap = overlap;
+}
+
+bool ImageProcessor::filterTiled(const FilterSpec& spec, Image<double>& output) {
+    if (grayImage.empty()) {
+        std::cerr << "No image loaded for tiled filtering!" << std::endl;
+        output.clear();
+        return false;
+    }
+    
+    // 灰度图、输出图像，每个工作单元的块图像、滤波结果、块频谱和逆变换工作区（filterTilesRaw 一次分配），
+    // 以及每个线程上块尺寸变换的线程局部缓冲区
+    size_t pixels = Image<double>::alignedStride(width) * static_cast<size_t>(height);
+    size_t tileBytes = 2 * Image<double>::alignedStride(tileSize) * static_cast<size_t>(tileSize) * sizeof(double) +
+                       2 * Spectrum<Complex>::alignedStride(FFT2D::halfWidth(tileSize)) * static_cast<size_t>(tileSize) *
+                       sizeof(Complex);
+    size_t threads = static_cast<size_t>(getThreadCount());
+    size_t bytes = 2 * pixels * sizeof(double) + tileBytes * std::min(threads, tileCount()) +
+                   FFT2D::scratchBytes<double>(tileSize, tileSize) * threads;
+    if (!checkMemoryBudget(bytes, "Tiled filtering")) {
+        output.clear();
+        return false;
+    }
+    
+    int core = tileSize - 2 * tileOverlap;
+    if (validation) {
+        std::cout << "Tiled " << filterShapeName(spec.shape) << " " << filterBandName(spec.band)
+                  << " filter: " << width << "x" << height << ", tile=" << tileSize << ", overlap=" << tileOverlap
+                  << ", tiles=" << (width + core - 1) / core << "x" << (height + core - 1) / core << std::endl;
+    }
+    
+    try {
+        using Clock = std::chrono::steady_clock;
+        auto start = Clock::now();
+        filterTilesRaw(spec, output);
+        
+        // 与 ifft2D 相同：值域明显异常时重新计算并按值域线性映射到 [0, 255]
+        double minVal = 0.0, maxVal = 0.0;
+        if (clampReconstruction(output, minVal, maxVal)) {
+            std::cout << "Renormalizing tiled result..." << std::endl;
+            filterTilesRaw(spec, output);
+            renormalizeReconstruction(output, minVal, maxVal);
+        }
+        if (validation) {
+            std::cout << "Tiled filtering completed in "
+                      << std::chrono::duration<double, std::milli>(Clock::now() - start).count() << " ms" << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Tiled filtering failed: " << e.what() << std::endl;
+        output.clear();
+        return false;
+    }
+    return true;
+}
+
+void ImageProcessor::filterTilesRaw(const FilterSpec& spec, Image<double>& output) {
+    const RadialTransferLUT& lut = transferTable(spec);
+    int tile = tileSize;
+    int overlap = tileOverlap;
+    int core = tile - 2 * overlap;
+    int tilesX = (width + core - 1) / core;
+    int tiles = static_cast<int>(tileCount());
+    int half = FFT2D::halfWidth(tile);
+    // 块上的频率 (kx, ky) 对应原图的频率 (kx·W/T, ky·H/T)
+    double scaleX = static_cast<double>(width) / tile;
+    double scaleY = static_cast<double>(height) / tile;
+    
+    output.resize(width, height);
+    
+    // 每个工作单元的块缓冲区在开始前一次分配（与 filterTiled 的内存估计一致），
+    // 块尺寸变换的线程局部缓冲区同样预先建立
+    int units = static_cast<int>(std::min(static_cast<size_t>(getThreadCount()), tileCount()));
+    std::vector<TileBuffers> buffers(units);
+    for (TileBuffers& buffer : buffers) {
+        buffer.block.resize(tile, tile);
+        buffer.filtered.resize(tile, tile);
+        buffer.spectrum.resize(half, tile);
+        buffer.work.resize(half, tile);
+    }
+    FFT2D::reserveScratch<double>(tile, tile);
+    
+    // 各块互不相关：工作单元 u 依次处理第 u、u + units、... 块，块的计算量相同，负载均衡；
+    // 块内的变换是嵌套调用，在本线程串行执行
+    ThreadPool::global().parallelFor(0, units, 1, [&](int begin, int end) {
+        for (int u = begin; u < end; u++) {
+            TileBuffers& buffer = buffers[u];
+            for (int t = u; t < tiles; t += units) {
+                filterTile(lut, t % tilesX * core, t / tilesX * core, scaleX, scaleY, buffer, output);
             }
         }
+    });
+}
+
+void ImageProcessor::filterTile(const RadialTransferLUT& lut, int x0, int y0, double scaleX, double scaleY,
+                                TileBuffers& buffer, Image<double>& output) const {
+    int tile = tileSize;
+    int overlap = tileOverlap;
+    int core = tile - 2 * overlap;
+    int half = FFT2D::halfWidth(tile);
+    
+    // 取出含重叠区的块，超出图像的部分镜像填充
+    for (int y = 0; y < tile; y++) {
+        const double* src = grayImage.row(reflectIndex(y0 - overlap + y, height));
+        double* dst = buffer.block.row(y);
+        for (int x = 0; x < tile; x++) {
+            dst[x] = src[reflectIndex(x0 - overlap + x, width)];
+        }
+    }
+    
+    FFT2D::forwardR2C(buffer.block, buffer.spectrum);
+    for (int y = 0; y < tile; y++) {
+        double ky = FFT2D::centeredOffset(y, tile) * scaleY;
+        Complex* row = buffer.spectrum.row(y);
+        for (int x = 0; x < half; x++) {
+            double kx = x * scaleX;
+            double gain = lut(std::llround(kx * kx + ky * ky));
+            row[x] = Complex(row[x].real * gain, row[x].imag * gain);
+        }
     }
+    FFT2D::inverseC2R(buffer.spectrum, tile, buffer.filtered, buffer.work);
     
-    // 移位回原来的位置
-    return ifftShift(centeredFreq);
+    // 只保留中心部分，重叠区中受循环卷积影响的像素丢弃
+    int w = std::min(core, width - x0);
+    int h = std::min(core, height - y0);
+    for (int y = 0; y < h; y++) {
+        const double* src = buffer.filtered.row(overlap + y) + overlap;
+        std::copy(src, src + w, output.row(y0 + y) + x0);
+    }
 }
 
-// FFT移位函数（将频域中心化）
-std::vector<std::vector<Complex>> ImageProcessor::fftShift(const std::vector<std::vector<Complex>>& input) {
-    int rows = input.size();
-    int cols = input[0].size();
-    std::vector<std::vector<Complex>> shifted(rows, std::vector<Complex>(cols));
+size_t ImageProcessor::tileCount() const {
+    int core = tileSize - 2 * tileOverlap;
+    return static_cast<size_t>((width + core - 1) / core) * static_cast<size_t>((height + core - 1) / core);
+}
+
+Spectrum<Complex> ImageProcessor::lowPassFilterCentered(double cutoffRatio) {
+    if (frequencyDomain.empty()) {
+        std::cerr << "No frequency domain data available for filtering!" << std::endl;
+        return Spectrum<Complex>();
+    }
     
-    int halfRows = rows / 2;
-    int halfCols = cols / 2;
+    Spectrum<Complex> filtered;
     
-    // 四个象限的交换
-    for (int y = 0; y < rows; y++) {
-        for (int x = 0; x < cols; x++) {
-            int newY = (y + halfRows) % rows;
-            int newX = (x + halfCols) % cols;
-            shifted[newY][newX] = input[y][x];
-        }
-    }
+    // 截止半径以较短边为基准
+    double maxRadius = std::min(width, height) / 2.0 * cutoffRatio;
+    
+    FilterGeometry::get(width, height)->select(frequencyDomain, filtered, -1,
+                                               FilterGeometry::squaredRadiusAtMost(maxRadius));
     
-    return shifted;
+    return filtered;
 }
 
-// 逆FFT移位函数
-std::vector<std::vector<Complex>> ImageProcessor::ifftShift(const std::vector<std::vector<Complex>>& input) {
-    // ifftShift与fftShift是相同的操作（对于偶数尺寸）
-    return fftShift(input);
+FFT2D::CenteredSpectrumView<double> ImageProcessor::getCenteredView() const {
+    if (frequencyDomain.empty()) {
+        return FFT2D::CenteredSpectrumView<double>();
+    }
+    return FFT2D::CenteredSpectrumView<double>(frequencyDomain, width);
 }
 
-double ImageProcessor::calculateMSE(const std::vector<std::vector<double>>& img1,
-                                   const std::vector<std::vector<double>>& img2) {
+Complex ImageProcessor::getCenteredCoefficient(int x, int y) const {
+    return FFT2D::centeredCoefficient(frequencyDomain, width, x, y);
+}
+
+double ImageProcessor::calculateMSE(const Image<double>& img1, const Image<double>& img2) {
     double mse = 0.0;
     for (int y = 0; y < height; y++) {
         for (int x = 0; x < width; x++) {
@@ -665,8 +1215,7 @@ double ImageProcessor::calculatePSNR(double mse) {
     return 10 * log10((255.0 * 255.0) / mse);
 }
 
-double ImageProcessor::calculateSSIM(const std::vector<std::vector<double>>& img1,
-                                    const std::vector<std::vector<double>>& img2) {
+double ImageProcessor::calculateSSIM(const Image<double>& img1, const Image<double>& img2) {
     // 简化的SSIM计算
     double mean1 = 0, mean2 = 0;
     double var1 = 0, var2 = 0, cov = 0;
@@ -732,14 +1281,17 @@ std::vector<float> ImageProcessor::getFrequencyVisualizationData() {
                 float posX = (float)x / width * 2.0f - 1.0f;
                 float posY = (float)y / height * 2.0f - 1.0f;
                 
+                // 按需从半频谱展开中心化坐标处的系数
+                Complex coefficient = FFT2D::centeredCoefficient(frequencyDomain, width, x, y);
+                
                 // 幅度（对数处理）
-                double magnitude = frequencyDomain[y][x].magnitude();
+                double magnitude = coefficient.magnitude();
                 if (!std::isfinite(magnitude)) magnitude = 0.0;
                 
                 float posZ = static_cast<float>(log(1.0 + magnitude) * 0.02f); // 更保守的缩放
                 
                 // 相位转换为颜色
-                double phase = frequencyDomain[y][x].phase();
+                double phase = coefficient.phase();
                 if (!std::isfinite(phase)) phase = 0.0;
                 
                 float r = static_cast<float>((sin(phase) + 1.0) * 0.5);
@@ -760,7 +1312,7 @@ std::vector<float> ImageProcessor::getFrequencyVisualizationData() {
     return vertices;
 }
 
-bool ImageProcessor::saveImage(const std::string& filename, const std::vector<std::vector<double>>& image) {
+bool ImageProcessor::saveImage(const std::string& filename, const Image<double>& image) {
     // 准备图像数据
     std::vector<unsigned char> imageData(width * height);
     
@@ -799,10 +1351,20 @@ bool ImageProcessor::saveImage(const std::string& filename, const std::vector<st
     }
 }
 
+void ImageProcessor::setThreadCount(int count) {
+    ThreadPool::global().setThreadCount(count);
+    std::cout << "FFT threads: " << ThreadPool::global().threadCount() << std::endl;
+}
+
+int ImageProcessor::getThreadCount() const {
+    return ThreadPool::global().threadCount();
+}
+
 void ImageProcessor::printImageInfo() const {
     std::cout << "\n=== Image Information ===" << std::endl;
     std::cout << "Dimensions: " << width << "x" << height << std::endl;
     std::cout << "Original channels: " << originalChannels << std::endl;
+    std::cout << "Gray conversion: " << GrayConverter::modeName(grayMode) << std::endl;
     std::cout << "Total pixels: " << (width * height) << std::endl;
     
     if (!grayImage.empty()) {
@@ -836,10 +1398,12 @@ void ImageProcessor::analyzeFrequencyDomain() const {
     
     std::cout << "\n=== Frequency Domain Analysis ===" << std::endl;
     
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
+    for (int y = 0; y < frequencyDomain.height(); y++) {
+        for (int x = 0; x < frequencyDomain.width(); x++) {
             double magnitude = frequencyDomain[y][x].magnitude();
-            totalEnergy += magnitude * magnitude;
+            // 半频谱中除直流列（及偶数宽度的奈奎斯特列）外，每个系数代表一对共轭对称分量
+            bool selfConjugate = (x == 0) || (width % 2 == 0 && x == width / 2);
+            totalEnergy += (selfConjugate ? 1.0 : 2.0) * magnitude * magnitude;
             
             if (magnitude > maxMagnitude) {
                 maxMagnitude = magnitude;
@@ -872,10 +1436,11 @@ void ImageProcessor::analyzeFrequencySpectrum() const {
     // 检查关键位置的幅度值
     std::cout << "关键位置幅度值：" << std::endl;
     std::cout << "DC分量 (0,0): " << frequencyDomain[0][0].magnitude() << std::endl;
-    std::cout << "右上角 (0," << (width-1) << "): " << frequencyDomain[0][width-1].magnitude() << std::endl;
+    int lastX = frequencyDomain.width() - 1;
+    std::cout << "右上角 (0," << lastX << "): " << frequencyDomain[0][lastX].magnitude() << std::endl;
     std::cout << "左下角 (" << (height-1) << ",0): " << frequencyDomain[height-1][0].magnitude() << std::endl;
-    std::cout << "右下角 (" << (height-1) << "," << (width-1) << "): " << frequencyDomain[height-1][width-1].magnitude() << std::endl;
-    std::cout << "中心 (" << (height/2) << "," << (width/2) << "): " << frequencyDomain[height/2][width/2].magnitude() << std::endl;
+    std::cout << "右下角 (" << (height-1) << "," << lastX << "): " << frequencyDomain[height-1][lastX].magnitude() << std::endl;
+    std::cout << "中心 (" << (height/2) << "," << lastX << "): " << frequencyDomain[height/2][lastX].magnitude() << std::endl;
     
     // 分析不同区域的平均幅度
     double cornerSum = 0, centerSum = 0, edgeSum = 0;
@@ -884,19 +1449,18 @@ void ImageProcessor::analyzeFrequencySpectrum() const {
     int quarterW = width / 4;
     int quarterH = height / 4;
     
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
+    // 半频谱只覆盖 kx ∈ [0, W/2]，右半部分与左半部分共轭对称，幅度相同
+    for (int y = 0; y < frequencyDomain.height(); y++) {
+        for (int x = 0; x < frequencyDomain.width(); x++) {
             double magnitude = frequencyDomain[y][x].magnitude();
             
             // 角落区域 (低频)
-            if ((x < quarterW || x >= width - quarterW) && 
-                (y < quarterH || y >= height - quarterH)) {
+            if (x < quarterW && (y < quarterH || y >= height - quarterH)) {
                 cornerSum += magnitude;
                 cornerCount++;
             }
             // 中心区域 (高频)
-            else if (x >= quarterW && x < width - quarterW && 
-                     y >= quarterH && y < height - quarterH) {
+            else if (x >= quarterW && y >= quarterH && y < height - quarterH) {
                 centerSum += magnitude;
                 centerCount++;
             }
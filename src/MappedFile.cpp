@@ -0,0 +1,268 @@
+#include "MappedFile.h"
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+
+#ifdef _WIN32
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <unistd.h>
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <cerrno>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        std::swap(address, other.address);
+        std::swap(length, other.length);
+        std::swap(reason, other.reason);
+#ifdef _WIN32
+        std::swap(fileHandle, other.fileHandle);
+        std::swap(mappingHandle, other.mappingHandle);
+#else
+        std::swap(descriptor, other.descriptor);
+#endif
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::createScratch(const std::string& directory, size_t bytes) {
+    close();
+    if (bytes == 0) {
+        return false;
+    }
+
+    char path[MAX_PATH];
+    if (GetTempFileNameA(directory.c_str(), "fft", 0, path) == 0) {
+        std::cerr << "Cannot create scratch file in " << directory << std::endl;
+        return false;
+    }
+    HANDLE file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                              FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Cannot open scratch file " << path << std::endl;
+        DeleteFileA(path);
+        return false;
+    }
+    DWORD high = static_cast<DWORD>(static_cast<unsigned long long>(bytes) >> 32);
+    DWORD low = static_cast<DWORD>(bytes & 0xFFFFFFFFull);
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, high, low, nullptr);
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, bytes) : nullptr;
+    if (!view) {
+        std::cerr << "Cannot map " << bytes << " bytes of scratch file " << path << std::endl;
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    address = view;
+    length = bytes;
+    return true;
+}
+
+bool MappedFile::openReadOnly(const std::string& path) {
+    close();
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        reason = "cannot open " + path;
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0 ||
+        static_cast<unsigned long long>(fileSize.QuadPart) > static_cast<unsigned long long>(SIZE_MAX)) {
+        reason = "cannot map " + path + ": empty or unsupported size";
+        CloseHandle(file);
+        return false;
+    }
+    size_t bytes = static_cast<size_t>(fileSize.QuadPart);
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, bytes) : nullptr;
+    if (!view) {
+        reason = "cannot map " + std::to_string(bytes) + " bytes of " + path;
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    address = view;
+    length = bytes;
+    return true;
+}
+
+void MappedFile::close() {
+    if (address) {
+        UnmapViewOfFile(address);
+    }
+    if (mappingHandle) {
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+    }
+    if (fileHandle) {
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+    }
+    address = nullptr;
+    length = 0;
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+}
+
+void MappedFile::adviseSequential(size_t, size_t) {
+}
+
+void MappedFile::release(size_t offset, size_t bytes) {
+    if (!address || offset >= length) {
+        return;
+    }
+    // 把页面移出工作集，内容保留在文件中
+    VirtualUnlock(static_cast<char*>(address) + offset, std::min(bytes, length - offset));
+}
+
+std::string MappedFile::defaultScratchDirectory() {
+    char path[MAX_PATH];
+    DWORD count = GetTempPathA(MAX_PATH, path);
+    return count > 0 && count < MAX_PATH ? std::string(path, count) : std::string(".");
+}
+
+#else
+
+bool MappedFile::createScratch(const std::string& directory, size_t bytes) {
+    close();
+    if (bytes == 0) {
+        return false;
+    }
+
+    std::string pattern = directory + "/fft-scratch-XXXXXX";
+    std::vector<char> path(pattern.begin(), pattern.end());
+    path.push_back('\0');
+    int fd = mkstemp(path.data());
+    if (fd < 0) {
+        std::cerr << "Cannot create scratch file in " << directory << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    // 只通过映射访问，立即删除目录项
+    unlink(path.data());
+
+    // 预先分配磁盘空间：磁盘已满时在这里失败，而不是在写入映射时收到 SIGBUS
+#ifdef __linux__
+    int error = posix_fallocate(fd, 0, static_cast<off_t>(bytes));
+#else
+    int error = ftruncate(fd, static_cast<off_t>(bytes)) == 0 ? 0 : errno;
+#endif
+    if (error != 0) {
+        std::cerr << "Cannot allocate " << bytes << " bytes of scratch file in " << directory
+                  << ": " << std::strerror(error) << std::endl;
+        ::close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) {
+        std::cerr << "Cannot map " << bytes << " bytes of scratch file: " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    descriptor = fd;
+    address = view;
+    length = bytes;
+    return true;
+}
+
+bool MappedFile::openReadOnly(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        reason = "cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size <= 0) {
+        // 管道、设备和空文件无法映射
+        reason = "cannot map " + path + ": not a non-empty regular file";
+        ::close(fd);
+        return false;
+    }
+    size_t bytes = static_cast<size_t>(info.st_size);
+    void* view = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED) {
+        reason = "cannot map " + std::to_string(bytes) + " bytes of " + path + ": " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+
+    descriptor = fd;
+    address = view;
+    length = bytes;
+    return true;
+}
+
+void MappedFile::close() {
+    if (address) {
+        munmap(address, length);
+    }
+    if (descriptor >= 0) {
+        ::close(descriptor);
+    }
+    address = nullptr;
+    length = 0;
+    descriptor = -1;
+}
+
+namespace {
+
+// 把 [offset, offset + bytes) 缩小到完整的页面范围内；没有完整页面时返回 false
+bool pageRange(size_t length, size_t& offset, size_t& bytes) {
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t end = std::min(offset + bytes, length);
+    size_t begin = (offset + page - 1) / page * page;
+    end = end / page * page;
+    if (begin >= end) {
+        return false;
+    }
+    offset = begin;
+    bytes = end - begin;
+    return true;
+}
+
+}
+
+void MappedFile::adviseSequential(size_t offset, size_t bytes) {
+    if (address && pageRange(length, offset, bytes)) {
+        madvise(static_cast<char*>(address) + offset, bytes, MADV_SEQUENTIAL);
+    }
+}
+
+void MappedFile::release(size_t offset, size_t bytes) {
+    // 共享文件映射上的 MADV_DONTNEED 只解除页面映射，脏页仍会写回文件
+    if (address && pageRange(length, offset, bytes)) {
+        madvise(static_cast<char*>(address) + offset, bytes, MADV_DONTNEED);
+    }
+}
+
+std::string MappedFile::defaultScratchDirectory() {
+    const char* dir = std::getenv("TMPDIR");
+    return dir && *dir ? std::string(dir) : std::string("/tmp");
+}
+
+#endif
@@ -0,0 +1,169 @@
+#include "OutOfCoreFFT.h"
+#include "FFT2D.h"
+#include "FFTPlan.h"
+#include "ThreadPool.h"
+#include <iostream>
+#include <algorithm>
+
+namespace {
+
+// 条带的最小行数：转置时每段连续写入至少这么多个复数
+constexpr int MinStripRows = 64;
+// 分块转置的块边长，一块（32×32 个复数，16KB）留在 L1/L2 中
+constexpr int TransposeTile = 32;
+
+// 在 workBytes 之内一个条带可以容纳的行数（每行 rowElements 个复数），不超过 total
+int stripRows(size_t workBytes, int rowElements, int total) {
+    size_t rowBytes = Spectrum<Complex>::alignedStride(rowElements) * sizeof(Complex);
+    size_t fit = std::max<size_t>(workBytes / rowBytes, MinStripRows);
+    return static_cast<int>(std::min<size_t>(fit, total));
+}
+
+// 行变换条带的行数：行变换把相邻两行打包成一次复数FFT，条带取偶数行，
+// 使行对的划分与整幅变换相同，结果与内存中的变换逐位一致
+int pairedStripRows(size_t workBytes, int rowElements, int total) {
+    int rows = stripRows(workBytes, rowElements, total);
+    return rows < total ? rows & ~1 : rows;
+}
+
+size_t spectrumBytes(int columns, int rows) {
+    return Spectrum<Complex>::alignedStride(columns) * static_cast<size_t>(rows) * sizeof(Complex);
+}
+
+// dst[dstRow + c][dstColumn + r] = src[srcRow + r][srcColumn + c]，r < rows，c < columns
+// 按 TransposeTile 分块，各列块并行
+void transpose(const Spectrum<Complex>& src, int srcRow, int srcColumn, int rows, int columns,
+               Spectrum<Complex>& dst, int dstRow, int dstColumn) {
+    int tiles = (columns + TransposeTile - 1) / TransposeTile;
+    ThreadPool::global().parallelFor(0, tiles, 0, [&](int tileBegin, int tileEnd) {
+        for (int c0 = tileBegin * TransposeTile; c0 < std::min(tileEnd * TransposeTile, columns); c0 += TransposeTile) {
+            int cEnd = std::min(c0 + TransposeTile, columns);
+            for (int r0 = 0; r0 < rows; r0 += TransposeTile) {
+                int rEnd = std::min(r0 + TransposeTile, rows);
+                for (int c = c0; c < cEnd; c++) {
+                    Complex* out = dst.row(dstRow + c) + dstColumn;
+                    for (int r = r0; r < rEnd; r++) {
+                        out[r] = src.row(srcRow + r)[srcColumn + c];
+                    }
+                }
+            }
+        }
+    });
+}
+
+// 原地变换 data 的第 [begin, end) 行
+void transformRows(Spectrum<Complex>& data, int begin, int end, const FFTPlan& plan, bool inverse) {
+    ThreadPool::global().parallelFor(begin, end, 1, [&](int rowBegin, int rowEnd) {
+        for (int r = rowBegin; r < rowEnd; r++) {
+            if (inverse) {
+                plan.inverse(data.row(r));
+            } else {
+                plan.forward(data.row(r));
+            }
+        }
+    });
+}
+
+}
+
+namespace OutOfCoreFFT {
+
+size_t scratchBytes(int width, int height) {
+    int half = FFT2D::halfWidth(width);
+    return spectrumBytes(half, height) + spectrumBytes(height, half);
+}
+
+bool forwardR2C(const Image<double>& input, const std::string& scratchDirectory, size_t workBytes,
+                MappedFile& spectrumFile, Spectrum<Complex>& spectrum) {
+    int width = input.width();
+    int height = input.height();
+    int half = FFT2D::halfWidth(width);
+    spectrum.release();
+
+    // 转置文件：half 行，第 x 行是频谱的第 x 列
+    MappedFile transposedFile;
+    if (!transposedFile.createScratch(scratchDirectory, spectrumBytes(height, half)) ||
+        !spectrumFile.createScratch(scratchDirectory, spectrumBytes(half, height))) {
+        spectrumFile.close();
+        return false;
+    }
+    Spectrum<Complex> transposed = Spectrum<Complex>::view(static_cast<Complex*>(transposedFile.data()), height, half,
+                                                           Spectrum<Complex>::alignedStride(height));
+    Spectrum<Complex> result = Spectrum<Complex>::view(static_cast<Complex*>(spectrumFile.data()), half, height,
+                                                       Spectrum<Complex>::alignedStride(half));
+
+    // 第一步：按行条带做行变换，条带转置后写入转置文件（每一行写入一段连续数据）
+    int rows = pairedStripRows(workBytes, half, height);
+    Spectrum<Complex> strip;
+    for (int y0 = 0; y0 < height; y0 += rows) {
+        int count = std::min(rows, height - y0);
+        strip.resize(half, count);
+        FFT2D::forwardRows(input, y0, y0 + count, strip);
+        transpose(strip, 0, 0, count, half, transposed, 0, y0);
+    }
+    strip.release();
+
+    // 第二步：转置文件按行块顺序读入，原地做列变换后转置写回频谱文件；
+    // 处理完的行块不再需要，立即交还其页面
+    auto colPlan = FFTPlan::get(height);
+    int columns = stripRows(workBytes, height, half);
+    size_t rowBytes = transposed.stride() * sizeof(Complex);
+    transposedFile.adviseSequential(0, transposedFile.size());
+    for (int x0 = 0; x0 < half; x0 += columns) {
+        int count = std::min(columns, half - x0);
+        transformRows(transposed, x0, x0 + count, *colPlan, false);
+        transpose(transposed, x0, 0, count, height, result, 0, x0);
+        transposedFile.release(x0 * rowBytes, count * rowBytes);
+    }
+
+    spectrum = std::move(result);
+    return true;
+}
+
+bool inverseC2R(const Spectrum<Complex>& input, int width, const std::string& scratchDirectory,
+                size_t workBytes, Image<double>& output, int activeColumns) {
+    int height = input.height();
+    int half = input.width();
+    if (FFT2D::halfWidth(width) != half) {
+        std::cerr << "Out-of-core IFFT: spectrum width does not match image width" << std::endl;
+        return false;
+    }
+    if (activeColumns < 0 || activeColumns > half) {
+        activeColumns = half;
+    }
+    output.resize(width, height);
+    if (activeColumns == 0) {
+        output.fill(0.0);
+        return true;
+    }
+
+    // 只有前 activeColumns 列可能非零，转置文件只保存这些列
+    MappedFile transposedFile;
+    if (!transposedFile.createScratch(scratchDirectory, spectrumBytes(height, activeColumns))) {
+        return false;
+    }
+    Spectrum<Complex> transposed = Spectrum<Complex>::view(static_cast<Complex*>(transposedFile.data()), height,
+                                                           activeColumns, Spectrum<Complex>::alignedStride(height));
+
+    // 第一步：按列块把频谱转置写入转置文件，原地做列逆变换
+    auto colPlan = FFTPlan::get(height);
+    int columns = stripRows(workBytes, height, activeColumns);
+    for (int x0 = 0; x0 < activeColumns; x0 += columns) {
+        int count = std::min(columns, activeColumns - x0);
+        transpose(input, 0, x0, height, count, transposed, x0, 0);
+        transformRows(transposed, x0, x0 + count, *colPlan, true);
+    }
+
+    // 第二步：按行条带从转置文件中取回各列的一段，做行逆变换后写入输出图像
+    int rows = pairedStripRows(workBytes, half, height);
+    Spectrum<Complex> strip;
+    for (int y0 = 0; y0 < height; y0 += rows) {
+        int count = std::min(rows, height - y0);
+        strip.resize(half, count);
+        transpose(transposed, 0, y0, activeColumns, count, strip, 0, 0);
+        FFT2D::inverseRows(strip, width, activeColumns, output, y0);
+    }
+    return true;
+}
+
+}
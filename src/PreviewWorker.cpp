@@ -0,0 +1,99 @@
+#include "PreviewWorker.h"
+#include <iostream>
+#include <utility>
+#include <exception>
+
+PreviewWorker::PreviewWorker() {
+    thread = std::thread(&PreviewWorker::workerLoop, this);
+}
+
+PreviewWorker::~PreviewWorker() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        pending = nullptr;
+        latest.fetch_add(1, std::memory_order_relaxed);
+    }
+    wake.notify_all();
+    thread.join();
+}
+
+void PreviewWorker::submit(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending = std::move(job);
+        latest.fetch_add(1, std::memory_order_relaxed);
+    }
+    wake.notify_one();
+}
+
+void PreviewWorker::cancelAndWait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    pending = nullptr;
+    latest.fetch_add(1, std::memory_order_relaxed);
+    idle.wait(lock, [&] { return !running; });
+    ready = false;
+}
+
+void PreviewWorker::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [&] { return !running && !pending; });
+}
+
+bool PreviewWorker::busy() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return running || static_cast<bool>(pending);
+}
+
+void PreviewWorker::Token::publish() const {
+    std::lock_guard<std::mutex> lock(owner->mutex);
+    if (cancelled()) {
+        return;
+    }
+    std::swap(owner->working, owner->completed);
+    owner->ready = true;
+}
+
+bool PreviewWorker::poll() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!ready) {
+        return false;
+    }
+    std::swap(front, completed);
+    ready = false;
+    return true;
+}
+
+void PreviewWorker::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [&] { return stopping || static_cast<bool>(pending); });
+        if (stopping) {
+            return;
+        }
+
+        Job job = std::move(pending);
+        pending = nullptr;
+        uint64_t generation = latest.load(std::memory_order_relaxed);
+        running = true;
+        lock.unlock();
+
+        bool finished = false;
+        try {
+            finished = job(working, Token(this, generation));
+        } catch (const std::exception& e) {
+            std::cerr << "Preview job failed: " << e.what() << std::endl;
+        }
+        // 任务对象可能持有较大的捕获，在锁外销毁
+        job = nullptr;
+
+        lock.lock();
+        running = false;
+        // 与 Token::publish() 相同：运行期间提交了更新的任务或被取消时，结果已经过时
+        if (finished && latest.load(std::memory_order_relaxed) == generation) {
+            std::swap(working, completed);
+            ready = true;
+        }
+        idle.notify_all();
+    }
+}
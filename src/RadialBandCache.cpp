@@ -0,0 +1,136 @@
+#include "RadialBandCache.h"
+#include "FilterGeometry.h"
+#include "FFT2D.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+// 计算环带权重时在半径方向上的采样数
+constexpr int WeightSamples = 16;
+
+}
+
+void RadialBandCache::build(const Spectrum<Complex>& spectrum, int imageWidth, int bands, double radiusScale) {
+    if (spectrum.empty() || bands <= 0) {
+        clear();
+        return;
+    }
+
+    bands = std::min(bands, MaxBands);
+    width = imageWidth;
+    height = spectrum.height();
+    scale = radiusScale;
+    dcLevel = spectrum[0][0].real / (static_cast<double>(width) * height);
+    images.resize(bands);
+
+    const FilterGeometry& geometry = *FilterGeometry::get(width, height);
+
+    // 每个任务的临时缓冲区在开始前一次分配（与 buildWorkBytes 一致）
+    struct TaskBuffers {
+        Spectrum<Complex> band;
+        Spectrum<Complex> work;
+        Image<double> spatial;
+    };
+    int tasks = std::min(bands, ThreadPool::global().threadCount());
+    std::vector<TaskBuffers> buffers(tasks);
+    for (TaskBuffers& buffer : buffers) {
+        buffer.band.resize(spectrum.width(), height);
+        buffer.work.resize(spectrum.width(), height);
+        buffer.spatial.resize(width, height);
+    }
+
+    // 各环带互不相关：任务 t 依次处理第 t、t + tasks、... 个环带；
+    // 任务内部的滤波和逆变换是嵌套调用，在本线程串行执行
+    ThreadPool::global().parallelFor(0, tasks, 1, [&](int begin, int end) {
+        for (int t = begin; t < end; t++) {
+            Spectrum<Complex>& band = buffers[t].band;
+            Spectrum<Complex>& work = buffers[t].work;
+            Image<double>& spatial = buffers[t].spatial;
+            for (int k = t; k < bands; k += tasks) {
+                // 环带 k 为 (r_k, r_{k+1}]，第 0 个环带不含直流分量；最后一个环带包含所有剩余系数
+                long long inner = k == 0 ? 0 : FilterGeometry::squaredRadiusAtMost(radiusScale * k / bands);
+                long long outer = k == bands - 1 ? std::numeric_limits<long long>::max()
+                                                 : FilterGeometry::squaredRadiusAtMost(radiusScale * (k + 1) / bands);
+                geometry.select(spectrum, band, inner, outer);
+                FFT2D::inverseC2R(band, width, spatial, work, geometry.columnsWithin(0, outer));
+
+                Image<float>& image = images[k];
+                image.resize(width, height);
+                for (int y = 0; y < height; y++) {
+                    const double* src = spatial.row(y);
+                    float* dst = image.row(y);
+                    for (int x = 0; x < width; x++) {
+                        dst[x] = static_cast<float>(src[x]);
+                    }
+                }
+            }
+        }
+    });
+}
+
+void RadialBandCache::clear() {
+    images.clear();
+    dcLevel = 0.0;
+    width = height = 0;
+}
+
+size_t RadialBandCache::memoryBytes() const {
+    size_t bytes = 0;
+    for (const Image<float>& image : images) {
+        bytes += image.capacity() * sizeof(float);
+    }
+    return bytes;
+}
+
+size_t RadialBandCache::estimateBytes(int width, int height, int bands) {
+    return Image<float>::alignedStride(width) * static_cast<size_t>(height) * sizeof(float) * std::min(bands, MaxBands);
+}
+
+size_t RadialBandCache::buildWorkBytes(int width, int height, int bands, int threads) {
+    size_t perTask = 2 * Spectrum<Complex>::alignedStride(FFT2D::halfWidth(width)) * static_cast<size_t>(height) *
+                         sizeof(Complex) +
+                     Image<double>::alignedStride(width) * static_cast<size_t>(height) * sizeof(double);
+    return perTask * static_cast<size_t>(std::max(0, std::min({ bands, MaxBands, threads })));
+}
+
+void RadialBandCache::compose(const FilterSpec& spec, Image<double>& output) const {
+    if (images.empty()) {
+        output.clear();
+        return;
+    }
+
+    // 权重：传递函数在环带上按面积（半径）加权的平均值
+    int bands = static_cast<int>(images.size());
+    double bandWidth = scale / bands;
+    double weights[MaxBands];
+    for (int k = 0; k < bands; k++) {
+        double weighted = 0.0, total = 0.0;
+        for (int s = 0; s < WeightSamples; s++) {
+            double r = bandWidth * (k + (s + 0.5) / WeightSamples);
+            weighted += RadialTransferLUT::evaluate(spec, scale, r) * r;
+            total += r;
+        }
+        weights[k] = weighted / total;
+    }
+    double dc = dcLevel * RadialTransferLUT::evaluate(spec, scale, 0.0);
+
+    output.resize(width, height);
+    ThreadPool::global().parallelFor(0, height, 0, [&](int yBegin, int yEnd) {
+        for (int y = yBegin; y < yEnd; y++) {
+            double* out = output.row(y);
+            std::fill(out, out + width, dc);
+            for (int k = 0; k < bands; k++) {
+                double w = weights[k];
+                if (w == 0.0) {
+                    continue;
+                }
+                const float* in = images[k].row(y);
+                for (int x = 0; x < width; x++) {
+                    out[x] += w * in[x];
+                }
+            }
+        }
+    });
+}
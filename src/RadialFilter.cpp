@@ -0,0 +1,111 @@
+#include "RadialFilter.h"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+const double PI = 3.14159265358979323846;
+
+// 半径 d 处的低通传递函数，D 为截止半径
+double lowPassTransfer(const FilterSpec& spec, double D, double d) {
+    switch (spec.shape) {
+        case FilterShape::Gaussian:
+            if (D <= 0.0) {
+                return d <= 0.0 ? 1.0 : 0.0;
+            }
+            return std::exp(-d * d / (2.0 * D * D));
+
+        case FilterShape::Butterworth:
+            if (D <= 0.0) {
+                return d <= 0.0 ? 1.0 : 0.0;
+            }
+            return 1.0 / (1.0 + std::pow(d / D, 2.0 * std::max(1, spec.order)));
+
+        case FilterShape::RaisedCosine: {
+            double beta = std::min(std::max(spec.rolloff, 0.0), 1.0);
+            double a = D * (1.0 - beta);
+            double b = D * (1.0 + beta);
+            if (d <= a) {
+                return 1.0;
+            }
+            if (d >= b) {
+                return 0.0;
+            }
+            return 0.5 * (1.0 + std::cos(PI * (d - a) / (b - a)));
+        }
+
+        case FilterShape::Ideal:
+        default:
+            return d <= D ? 1.0 : 0.0;
+    }
+}
+
+// 高通/带通内侧边界上被去除的部分；理想滤波与 highPassFilter/bandPassFilter 一致，
+// 恰好位于截止半径上的系数保留
+double stopTransfer(const FilterSpec& spec, double D, double d) {
+    if (spec.shape == FilterShape::Ideal) {
+        return d < D ? 1.0 : 0.0;
+    }
+    return lowPassTransfer(spec, D, d);
+}
+
+}
+
+double RadialTransferLUT::evaluate(const FilterSpec& spec, double radiusScale, double d) {
+    switch (spec.band) {
+        case FilterBand::HighPass:
+            return 1.0 - stopTransfer(spec, spec.cutoff * radiusScale, d);
+        case FilterBand::BandPass:
+            return lowPassTransfer(spec, spec.bandHigh * radiusScale, d) *
+                   (1.0 - stopTransfer(spec, spec.bandLow * radiusScale, d));
+        case FilterBand::LowPass:
+        default:
+            return lowPassTransfer(spec, spec.cutoff * radiusScale, d);
+    }
+}
+
+void RadialTransferLUT::build(const FilterSpec& spec, double radiusScale, long long maxSquared) {
+    maxSquared = std::max(0LL, maxSquared);
+
+    // d² < ExactSize：每个整数一项
+    size_t exactCount = static_cast<size_t>(std::min<long long>(maxSquared + 1, ExactSize));
+    exact.resize(exactCount);
+    for (size_t i = 0; i < exactCount; i++) {
+        exact[i] = evaluate(spec, radiusScale, std::sqrt(static_cast<double>(i)));
+    }
+
+    // 更大的 d²：均匀量化
+    if (maxSquared >= ExactSize) {
+        step = std::max(1.0, static_cast<double>(maxSquared - ExactSize) / (CoarseSize - 1));
+        inverseStep = 1.0 / step;
+        coarse.resize(CoarseSize);
+        for (int i = 0; i < CoarseSize; i++) {
+            double squared = ExactSize + i * step;
+            coarse[i] = evaluate(spec, radiusScale, std::sqrt(squared));
+        }
+    } else {
+        step = inverseStep = 1.0;
+        coarse.clear();
+    }
+
+    // 从表尾开始把可忽略的尾部置零，并记录可能非零的最大 d²
+    support = -1;
+    for (size_t i = coarse.size(); i-- > 0;) {
+        if (std::abs(coarse[i]) >= TailEpsilon) {
+            // 第 i、i+1 个采样之间的插值结果仍可能非零
+            long long end = ExactSize + static_cast<long long>(std::ceil((i + 1) * step));
+            support = std::min(maxSquared, end);
+            break;
+        }
+        coarse[i] = 0.0;
+    }
+    if (support < 0) {
+        for (size_t i = exact.size(); i-- > 0;) {
+            if (std::abs(exact[i]) >= TailEpsilon) {
+                support = static_cast<long long>(i);
+                break;
+            }
+            exact[i] = 0.0;
+        }
+    }
+}
@@ -0,0 +1,885 @@
+#include "RowDecoder.h"
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+#ifdef HAS_ZLIB
+    #include <zlib.h>
+#endif
+
+namespace {
+
+constexpr size_t ReadBufferSize = 64 * 1024;
+// 宽高上限（与 stb_image 相同），防止损坏的文件头导致巨大的行缓冲区
+constexpr int MaxDimension = 1 << 24;
+
+// 顺序读取：从文件读取时带缓冲；从内存（映射的文件）读取时直接返回内存中的数据，不复制
+class ByteReader {
+public:
+    explicit ByteReader(std::FILE* file) : file(file), buffer(ReadBufferSize), base(buffer.data()) {}
+    ByteReader(const unsigned char* data, size_t size) : base(data), end(size) {}
+    ~ByteReader() {
+        if (file) {
+            std::fclose(file);
+        }
+    }
+
+    ByteReader(const ByteReader&) = delete;
+    ByteReader& operator=(const ByteReader&) = delete;
+
+    // 数据是否整个在内存中
+    bool inMemory() const { return file == nullptr; }
+
+    // 读取 n 字节，文件提前结束时返回 false
+    bool read(void* dst, size_t n) {
+        unsigned char* out = static_cast<unsigned char*>(dst);
+        while (n > 0) {
+            if (pos == end && !refill()) {
+                return false;
+            }
+            size_t count = std::min(n, end - pos);
+            std::memcpy(out, base + pos, count);
+            pos += count;
+            out += count;
+            n -= count;
+        }
+        return true;
+    }
+
+    bool skip(size_t n) {
+        while (n > 0) {
+            if (pos == end && !refill()) {
+                return false;
+            }
+            size_t count = std::min(n, end - pos);
+            pos += count;
+            n -= count;
+        }
+        return true;
+    }
+
+    // 读取一个字节，文件结束时返回 -1
+    int byte() {
+        if (pos == end && !refill()) {
+            return -1;
+        }
+        return base[pos++];
+    }
+
+    // 查看接下来的 n 个字节而不消耗（从文件读取时按需扩大缓冲区）；不足 n 字节时返回 nullptr
+    const unsigned char* peek(size_t n) {
+        if (end - pos < n && file) {
+            if (n > buffer.size()) {
+                buffer.resize(n);
+            }
+            std::memmove(buffer.data(), buffer.data() + pos, end - pos);
+            offset += pos;
+            end -= pos;
+            pos = 0;
+            base = buffer.data();
+            end += std::fread(buffer.data() + end, 1, buffer.size() - end, file);
+        }
+        return end - pos >= n ? base + pos : nullptr;
+    }
+
+    // 消耗接下来的 n 个字节并返回其地址，不足 n 字节时返回 nullptr。
+    // 从内存读取时不复制；从文件读取时地址只在下一次读取之前有效
+    const unsigned char* take(size_t n) {
+        const unsigned char* data = peek(n);
+        if (data) {
+            pos += n;
+        }
+        return data;
+    }
+
+    // 已读取的字节数（即当前的文件偏移）
+    size_t position() const { return offset + pos; }
+
+private:
+    bool refill() {
+        if (!file) {
+            return false;
+        }
+        offset += end;
+        pos = 0;
+        end = std::fread(buffer.data(), 1, buffer.size(), file);
+        return end > 0;
+    }
+
+    std::FILE* file = nullptr;
+    std::vector<unsigned char> buffer;
+    const unsigned char* base;   // 从文件读取时为 buffer.data()
+    size_t pos = 0;
+    size_t end = 0;
+    size_t offset = 0;   // base[0] 对应的文件偏移
+};
+
+inline uint32_t readLE16(const unsigned char* p) { return p[0] | (p[1] << 8); }
+inline uint32_t readLE32(const unsigned char* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24); }
+inline uint32_t readBE16(const unsigned char* p) { return (p[0] << 8) | p[1]; }
+inline uint32_t readBE32(const unsigned char* p) { return (static_cast<uint32_t>(p[0]) << 24) | (p[1] << 16) | (p[2] << 8) | p[3]; }
+
+bool validDimensions(long long w, long long h) {
+    return w > 0 && h > 0 && w <= MaxDimension && h <= MaxDimension;
+}
+
+// ---------------------------------------------------------------------------
+// PNM：P5（灰度）/ P6（RGB），maxval <= 255 为 8 位，否则为 16 位大端。
+// 样本按 maxval 换算到 0..255（stb_image 忽略 maxval，16 位时还取错了字节）
+
+class PnmDecoder : public RowDecoder {
+public:
+    explicit PnmDecoder(std::unique_ptr<ByteReader> input) : reader(std::move(input)) {}
+
+    bool readHeader() {
+        unsigned char magic[2];
+        if (!reader->read(magic, 2)) {
+            return false;
+        }
+        imageChannels = magic[1] == '6' ? 3 : 1;
+        long long w, h, maxValue;
+        if (!readNumber(w) || !readNumber(h) || !readNumber(maxValue) ||
+            !validDimensions(w, h) || maxValue <= 0 || maxValue > 65535) {
+            return false;
+        }
+        imageWidth = static_cast<int>(w);
+        imageHeight = static_cast<int>(h);
+        sampleBytes = maxValue > 255 ? 2 : 1;
+        maxSample = static_cast<uint32_t>(maxValue);
+        return true;
+    }
+
+    bool nextRow(unsigned char* row, int& y) override {
+        const unsigned char* data = nextRowData(row, y);
+        if (data && data != row) {
+            std::memcpy(row, data, static_cast<size_t>(imageWidth) * imageChannels);
+        }
+        return data != nullptr;
+    }
+
+    // 8 位且最大值为 255 的数据就是输出格式，直接返回文件中的这一行（从内存读取时不复制）
+    const unsigned char* nextRowData(unsigned char* row, int& y) override {
+        size_t samples = static_cast<size_t>(imageWidth) * imageChannels;
+        const unsigned char* in = reader->take(samples * sampleBytes);
+        if (!in) {
+            fail("PNM data ends early");
+            return nullptr;
+        }
+        y = nextY++;
+        if (sampleBytes == 1 && maxSample == 255) {
+            return in;
+        }
+        for (size_t i = 0; i < samples; i++) {
+            uint32_t value = sampleBytes == 2 ? readBE16(in + 2 * i) : in[i];
+            row[i] = static_cast<unsigned char>((std::min(value, maxSample) * 255 + maxSample / 2) / maxSample);
+        }
+        return row;
+    }
+
+private:
+    // 读取一个十进制数：跳过空白和 # 注释，数字之后必须是一个空白字符（一并消耗）
+    bool readNumber(long long& value) {
+        int c = reader->byte();
+        while (c == '#' || std::isspace(c)) {
+            if (c == '#') {
+                while (c >= 0 && c != '\n' && c != '\r') {
+                    c = reader->byte();
+                }
+            }
+            c = reader->byte();
+        }
+        if (c < 0 || !std::isdigit(c)) {
+            return false;
+        }
+        value = 0;
+        while (c >= 0 && std::isdigit(c)) {
+            value = value * 10 + (c - '0');
+            if (value > MaxDimension) {
+                return false;
+            }
+            c = reader->byte();
+        }
+        return c >= 0 && std::isspace(c);
+    }
+
+    std::unique_ptr<ByteReader> reader;
+    int sampleBytes = 1;
+    uint32_t maxSample = 255;
+    int nextY = 0;
+};
+
+// ---------------------------------------------------------------------------
+// BMP：未压缩的 1/4/8 位调色板、16/32 位（含位域掩码）和 24 位
+
+class BmpDecoder : public RowDecoder {
+public:
+    explicit BmpDecoder(std::unique_ptr<ByteReader> input) : reader(std::move(input)) {}
+
+    bool readHeader() {
+        unsigned char header[14 + 4];
+        if (!reader->read(header, sizeof(header))) {
+            return false;
+        }
+        uint32_t pixelOffset = readLE32(header + 10);
+        uint32_t infoSize = readLE32(header + 14);
+        if (infoSize != 12 && infoSize < 40) {
+            return false;
+        }
+
+        long long w, h;
+        uint32_t compression = 0, colorsUsed = 0;
+        if (infoSize == 12) {
+            unsigned char info[8];
+            if (!reader->read(info, sizeof(info))) {
+                return false;
+            }
+            w = readLE16(info);
+            h = readLE16(info + 2);
+            bitsPerPixel = readLE16(info + 6);
+        } else {
+            unsigned char info[36];
+            if (!reader->read(info, sizeof(info))) {
+                return false;
+            }
+            w = static_cast<int32_t>(readLE32(info));
+            h = static_cast<int32_t>(readLE32(info + 4));
+            bitsPerPixel = readLE16(info + 10);
+            compression = readLE32(info + 12);
+            colorsUsed = readLE32(info + 28);
+            // 0 = BI_RGB，3 = BI_BITFIELDS；RLE 等压缩格式交给 stb_image
+            if (compression != 0 && !(compression == 3 && (bitsPerPixel == 16 || bitsPerPixel == 32))) {
+                return false;
+            }
+            // 位域掩码：40 字节的信息头之后另有 3 个，更新版本的信息头中包含 4 个（含 alpha）
+            size_t extra = infoSize - 40;
+            if (compression == 3) {
+                unsigned char masks[16] = {};
+                size_t count = infoSize == 40 ? 12 : std::min<size_t>(16, extra);
+                if (!reader->read(masks, count)) {
+                    return false;
+                }
+                redMask = readLE32(masks);
+                greenMask = readLE32(masks + 4);
+                blueMask = readLE32(masks + 8);
+                alphaMask = readLE32(masks + 12);
+                if (infoSize > 40) {
+                    extra -= count;
+                }
+            }
+            if (!reader->skip(extra)) {
+                return false;
+            }
+        }
+
+        bool validDepth = bitsPerPixel == 1 || bitsPerPixel == 4 || bitsPerPixel == 8 ||
+                          bitsPerPixel == 16 || bitsPerPixel == 24 || bitsPerPixel == 32;
+        if (!validDepth || !validDimensions(w, h < 0 ? -h : h)) {
+            return false;
+        }
+        imageWidth = static_cast<int>(w);
+        imageHeight = static_cast<int>(h < 0 ? -h : h);
+        topDown = h < 0;
+
+        if (bitsPerPixel <= 8) {
+            size_t entries = colorsUsed ? std::min<uint32_t>(colorsUsed, 256) : (1u << bitsPerPixel);
+            size_t entrySize = infoSize == 12 ? 3 : 4;
+            std::vector<unsigned char> table(entries * entrySize);
+            if (!reader->read(table.data(), table.size())) {
+                return false;
+            }
+            palette.assign(256 * 3, 0);
+            for (size_t i = 0; i < entries; i++) {
+                palette[3 * i] = table[i * entrySize + 2];
+                palette[3 * i + 1] = table[i * entrySize + 1];
+                palette[3 * i + 2] = table[i * entrySize];
+            }
+            imageChannels = 3;
+        } else if (bitsPerPixel == 24) {
+            imageChannels = 3;
+        } else {
+            if (compression == 0) {
+                // 与 stb_image 相同：16 位默认为 5-5-5，32 位默认为 8-8-8-8
+                redMask = bitsPerPixel == 16 ? 0x7C00u : 0xFF0000u;
+                greenMask = bitsPerPixel == 16 ? 0x03E0u : 0x00FF00u;
+                blueMask = bitsPerPixel == 16 ? 0x001Fu : 0x0000FFu;
+                alphaMask = bitsPerPixel == 16 ? 0u : 0xFF000000u;
+            }
+            if (!redMask || !greenMask || !blueMask) {
+                return false;
+            }
+            imageChannels = alphaMask ? 4 : 3;
+        }
+
+        // 跳到像素数据
+        if (pixelOffset < reader->position() || !reader->skip(pixelOffset - reader->position())) {
+            return false;
+        }
+        rowBytes = (static_cast<size_t>(imageWidth) * bitsPerPixel + 31) / 32 * 4;
+        return true;
+    }
+
+    bool nextRow(unsigned char* row, int& y) override {
+        const unsigned char* in = reader->take(rowBytes);
+        if (!in) {
+            return fail("BMP data ends early");
+        }
+        int w = imageWidth;
+        if (bitsPerPixel <= 8) {
+            int perByte = 8 / bitsPerPixel;
+            int mask = (1 << bitsPerPixel) - 1;
+            for (int x = 0; x < w; x++) {
+                int shift = (perByte - 1 - x % perByte) * bitsPerPixel;
+                int index = (in[x / perByte] >> shift) & mask;
+                std::memcpy(row + 3 * x, &palette[3 * index], 3);
+            }
+        } else if (bitsPerPixel == 24) {
+            for (int x = 0; x < w; x++) {
+                row[3 * x] = in[3 * x + 2];
+                row[3 * x + 1] = in[3 * x + 1];
+                row[3 * x + 2] = in[3 * x];
+            }
+        } else {
+            int bytes = bitsPerPixel / 8;
+            int c = imageChannels;
+            for (int x = 0; x < w; x++) {
+                uint32_t pixel = bytes == 2 ? readLE16(in + 2 * x) : readLE32(in + 4 * x);
+                row[c * x] = extract(pixel, redMask);
+                row[c * x + 1] = extract(pixel, greenMask);
+                row[c * x + 2] = extract(pixel, blueMask);
+                if (c == 4) {
+                    row[c * x + 3] = extract(pixel, alphaMask);
+                }
+            }
+        }
+        y = topDown ? nextY : imageHeight - 1 - nextY;
+        nextY++;
+        return true;
+    }
+
+private:
+    // 按掩码取出一个分量并换算到 8 位：超过 8 位时取高 8 位，不足 8 位时按位重复填充（与 stb_image 相同）
+    static unsigned char extract(uint32_t pixel, uint32_t mask) {
+        static const uint32_t multiplier[9] = { 0, 0xFF, 0x55, 0x49, 0x11, 0x21, 0x41, 0x81, 0x01 };
+        static const int shiftBack[9] = { 0, 0, 0, 1, 0, 2, 4, 6, 0 };
+        int shift = 0;
+        while (!((mask >> shift) & 1)) {
+            shift++;
+        }
+        int bits = 0;
+        while (shift + bits < 32 && ((mask >> (shift + bits)) & 1)) {
+            bits++;
+        }
+        uint32_t value = (pixel & mask) >> shift;
+        if (bits > 8) {
+            value >>= bits - 8;
+            bits = 8;
+        }
+        return static_cast<unsigned char>((value * multiplier[bits]) >> shiftBack[bits]);
+    }
+
+    std::unique_ptr<ByteReader> reader;
+    size_t rowBytes = 0;                  // 每行字节数（含填充到 4 字节的部分）
+    std::vector<unsigned char> palette;   // 256 项 RGB
+    int bitsPerPixel = 0;
+    bool topDown = false;
+    uint32_t redMask = 0, greenMask = 0, blueMask = 0, alphaMask = 0;
+    int nextY = 0;
+};
+
+// ---------------------------------------------------------------------------
+// TGA：8 位灰度、24/32 位真彩色（BGR(A)）、8 位索引 + 24/32 位调色板，均可为 RLE 压缩
+
+class TgaDecoder : public RowDecoder {
+public:
+    explicit TgaDecoder(std::unique_ptr<ByteReader> input) : reader(std::move(input)) {}
+
+    bool readHeader() {
+        unsigned char header[18];
+        if (!reader->read(header, sizeof(header))) {
+            return false;
+        }
+        int idLength = header[0];
+        int colorMapType = header[1];
+        int imageType = header[2];
+        int mapFirst = readLE16(header + 3);
+        int mapLength = readLE16(header + 5);
+        int mapDepth = header[7];
+        int w = readLE16(header + 12);
+        int h = readLE16(header + 14);
+        int depth = header[16];
+        topDown = (header[17] & 0x20) != 0;
+
+        rle = imageType >= 9;
+        int baseType = rle ? imageType - 8 : imageType;
+        if (colorMapType > 1 || !validDimensions(w, h)) {
+            return false;
+        }
+        if (baseType == 1) {
+            if (colorMapType != 1 || depth != 8 || (mapDepth != 24 && mapDepth != 32)) {
+                return false;
+            }
+            imageChannels = mapDepth / 8;
+        } else if (baseType == 2) {
+            if (depth != 24 && depth != 32) {
+                return false;
+            }
+            imageChannels = depth / 8;
+        } else if (baseType == 3) {
+            if (depth != 8) {
+                return false;
+            }
+            imageChannels = 1;
+        } else {
+            return false;
+        }
+        imageWidth = w;
+        imageHeight = h;
+        pixelBytes = depth / 8;
+        indexed = baseType == 1;
+
+        if (!reader->skip(idLength)) {
+            return false;
+        }
+        if (colorMapType == 1) {
+            int entryBytes = (mapDepth + 7) / 8;
+            std::vector<unsigned char> table(static_cast<size_t>(mapLength) * entryBytes);
+            if (!reader->read(table.data(), table.size())) {
+                return false;
+            }
+            if (indexed) {
+                // 调色板转为 RGB(A)，索引从 mapFirst 开始
+                palette.assign(256 * 4, 0);
+                for (int i = 0; i < mapLength && mapFirst + i < 256; i++) {
+                    unsigned char* entry = &palette[4 * (mapFirst + i)];
+                    const unsigned char* src = &table[static_cast<size_t>(i) * entryBytes];
+                    entry[0] = src[2];
+                    entry[1] = src[1];
+                    entry[2] = src[0];
+                    entry[3] = entryBytes == 4 ? src[3] : 255;
+                }
+            }
+        }
+        if (rle) {
+            raw.resize(static_cast<size_t>(imageWidth) * pixelBytes);
+        }
+        return true;
+    }
+
+    bool nextRow(unsigned char* row, int& y) override {
+        const unsigned char* in = raw.data();
+        if (!rle) {
+            in = reader->take(static_cast<size_t>(imageWidth) * pixelBytes);
+            if (!in) {
+                return fail("TGA data ends early");
+            }
+        } else {
+            // RLE 包可以跨行，包的状态在行之间保留
+            for (int x = 0; x < imageWidth; x++) {
+                unsigned char* px = &raw[static_cast<size_t>(x) * pixelBytes];
+                if (runRemaining == 0) {
+                    int packet = reader->byte();
+                    if (packet < 0) {
+                        return fail("TGA data ends early");
+                    }
+                    runRemaining = (packet & 0x7F) + 1;
+                    runRaw = (packet & 0x80) == 0;
+                    if (!runRaw && !reader->read(runPixel, pixelBytes)) {
+                        return fail("TGA data ends early");
+                    }
+                }
+                runRemaining--;
+                if (runRaw) {
+                    if (!reader->read(px, pixelBytes)) {
+                        return fail("TGA data ends early");
+                    }
+                } else {
+                    std::memcpy(px, runPixel, pixelBytes);
+                }
+            }
+        }
+
+        int c = imageChannels;
+        for (int x = 0; x < imageWidth; x++) {
+            const unsigned char* px = in + static_cast<size_t>(x) * pixelBytes;
+            if (indexed) {
+                std::memcpy(row + c * x, &palette[4 * px[0]], c);
+            } else if (c == 1) {
+                row[x] = px[0];
+            } else {
+                row[c * x] = px[2];
+                row[c * x + 1] = px[1];
+                row[c * x + 2] = px[0];
+                if (c == 4) {
+                    row[c * x + 3] = px[3];
+                }
+            }
+        }
+        y = topDown ? nextY : imageHeight - 1 - nextY;
+        nextY++;
+        return true;
+    }
+
+private:
+    std::unique_ptr<ByteReader> reader;
+    std::vector<unsigned char> raw;       // RLE 解码后的一行
+    std::vector<unsigned char> palette;   // 256 项 RGBA
+    int pixelBytes = 1;
+    bool indexed = false;
+    bool rle = false;
+    bool topDown = false;
+    int runRemaining = 0;
+    bool runRaw = false;
+    unsigned char runPixel[4] = {};
+    int nextY = 0;
+};
+
+#ifdef HAS_ZLIB
+
+// ---------------------------------------------------------------------------
+// PNG：非隔行，位深 1/2/4/8/16，全部颜色类型；IDAT 数据按需送入 zlib 增量解压，
+// 每次只解压一行，反滤波只需要上一行
+
+class PngDecoder : public RowDecoder {
+public:
+    explicit PngDecoder(std::unique_ptr<ByteReader> input) : reader(std::move(input)) {}
+
+    ~PngDecoder() override {
+        if (streamReady) {
+            inflateEnd(&stream);
+        }
+    }
+
+    bool readHeader() {
+        if (!reader->skip(8)) {
+            return false;
+        }
+        bool haveHeader = false;
+        while (true) {
+            unsigned char chunk[8];
+            if (!reader->read(chunk, sizeof(chunk))) {
+                return false;
+            }
+            uint32_t length = readBE32(chunk);
+            const unsigned char* type = chunk + 4;
+            if (std::memcmp(type, "IDAT", 4) == 0) {
+                if (!haveHeader || (colorType == 3 && palette.empty())) {
+                    return false;
+                }
+                chunkRemaining = length;
+                break;
+            }
+            if (std::memcmp(type, "IHDR", 4) == 0) {
+                unsigned char ihdr[13];
+                if (length != 13 || !reader->read(ihdr, sizeof(ihdr)) || !parseHeader(ihdr)) {
+                    return false;
+                }
+                haveHeader = true;
+            } else if (std::memcmp(type, "PLTE", 4) == 0 && length <= 768 && length % 3 == 0) {
+                palette.assign(256 * 4, 0);
+                std::vector<unsigned char> entries(length);
+                if (!reader->read(entries.data(), length)) {
+                    return false;
+                }
+                for (uint32_t i = 0; i < length / 3; i++) {
+                    std::memcpy(&palette[4 * i], &entries[3 * i], 3);
+                    palette[4 * i + 3] = 255;
+                }
+            } else if (std::memcmp(type, "tRNS", 4) == 0 && haveHeader && length <= 256) {
+                unsigned char trns[256];
+                if (!reader->read(trns, length)) {
+                    return false;
+                }
+                applyTransparency(trns, length);
+            } else if (std::memcmp(type, "IEND", 4) == 0) {
+                return false;
+            } else if (!reader->skip(length)) {
+                return false;
+            }
+            // CRC
+            if (!reader->skip(4)) {
+                return false;
+            }
+        }
+
+        if (inflateInit(&stream) != Z_OK) {
+            return false;
+        }
+        streamReady = true;
+        rowBytes = (static_cast<size_t>(imageWidth) * samplesPerPixel * bitDepth + 7) / 8;
+        current.assign(rowBytes + 1, 0);
+        previous.assign(rowBytes + 1, 0);
+        return true;
+    }
+
+    bool nextRow(unsigned char* row, int& y) override {
+        // 解压一行：1 字节滤波类型 + rowBytes 字节数据
+        stream.next_out = current.data();
+        stream.avail_out = static_cast<uInt>(rowBytes + 1);
+        while (stream.avail_out > 0) {
+            if (stream.avail_in == 0 && !refillInput()) {
+                return fail("PNG data ends early");
+            }
+            int status = inflate(&stream, Z_NO_FLUSH);
+            if (status == Z_STREAM_END && stream.avail_out > 0) {
+                return fail("PNG data ends early");
+            }
+            if (status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR) {
+                return fail("corrupt PNG data");
+            }
+        }
+        if (!unfilter()) {
+            return fail("invalid PNG filter type");
+        }
+        expand(current.data() + 1, row);
+        std::swap(current, previous);
+        y = nextY++;
+        return true;
+    }
+
+private:
+    bool parseHeader(const unsigned char* ihdr) {
+        long long w = readBE32(ihdr);
+        long long h = readBE32(ihdr + 4);
+        bitDepth = ihdr[8];
+        colorType = ihdr[9];
+        // 隔行扫描（Adam7）无法逐行输出，交给 stb_image
+        if (!validDimensions(w, h) || ihdr[10] != 0 || ihdr[11] != 0 || ihdr[12] != 0) {
+            return false;
+        }
+        switch (colorType) {
+            case 0: samplesPerPixel = 1; break;
+            case 2: samplesPerPixel = 3; break;
+            case 3: samplesPerPixel = 1; break;
+            case 4: samplesPerPixel = 2; break;
+            case 6: samplesPerPixel = 4; break;
+            default: return false;
+        }
+        bool validDepth = colorType == 3 ? (bitDepth == 1 || bitDepth == 2 || bitDepth == 4 || bitDepth == 8)
+                        : (colorType == 0) ? (bitDepth == 1 || bitDepth == 2 || bitDepth == 4 || bitDepth == 8 || bitDepth == 16)
+                        : (bitDepth == 8 || bitDepth == 16);
+        if (!validDepth) {
+            return false;
+        }
+        imageWidth = static_cast<int>(w);
+        imageHeight = static_cast<int>(h);
+        imageChannels = colorType == 3 ? 3 : samplesPerPixel;
+        return true;
+    }
+
+    // 透明色：调色板图像为每项的 alpha，灰度/RGB 图像为一个关键色；与 stb_image 相同，多出一个 alpha 通道
+    void applyTransparency(const unsigned char* trns, uint32_t length) {
+        if (colorType == 3) {
+            if (palette.empty()) {
+                return;
+            }
+            for (uint32_t i = 0; i < length; i++) {
+                palette[4 * i + 3] = trns[i];
+            }
+            imageChannels = 4;
+        } else if ((colorType == 0 && length == 2) || (colorType == 2 && length == 6)) {
+            for (uint32_t i = 0; i < length / 2; i++) {
+                transparentKey[i] = readBE16(trns + 2 * i);
+            }
+            hasKey = true;
+            imageChannels = samplesPerPixel + 1;
+        }
+    }
+
+    bool refillInput() {
+        while (chunkRemaining == 0) {
+            unsigned char chunk[12];
+            // 上一个 IDAT 的 CRC 与下一个块的长度和类型
+            if (!reader->read(chunk, sizeof(chunk)) || std::memcmp(chunk + 8, "IDAT", 4) != 0) {
+                return false;
+            }
+            chunkRemaining = readBE32(chunk + 4);
+        }
+        // 从内存读取时整个 IDAT 块直接交给 zlib，否则每次送入一个缓冲区的数据
+        size_t count = reader->inMemory() ? chunkRemaining : std::min<size_t>(chunkRemaining, ReadBufferSize);
+        const unsigned char* data = reader->take(count);
+        if (!data) {
+            return false;
+        }
+        chunkRemaining -= static_cast<uint32_t>(count);
+        stream.next_in = const_cast<Bytef*>(data);
+        stream.avail_in = static_cast<uInt>(count);
+        return true;
+    }
+
+    bool unfilter() {
+        unsigned char* cur = current.data() + 1;
+        const unsigned char* prev = previous.data() + 1;
+        size_t bpp = std::max(1, samplesPerPixel * bitDepth / 8);
+        // 第一行的“上一行”为全零：previous 初始化为零
+        switch (current[0]) {
+            case 0:
+                break;
+            case 1:
+                for (size_t i = bpp; i < rowBytes; i++) cur[i] += cur[i - bpp];
+                break;
+            case 2:
+                for (size_t i = 0; i < rowBytes; i++) cur[i] += prev[i];
+                break;
+            case 3:
+                for (size_t i = 0; i < bpp; i++) cur[i] += prev[i] >> 1;
+                for (size_t i = bpp; i < rowBytes; i++) cur[i] += (cur[i - bpp] + prev[i]) >> 1;
+                break;
+            case 4:
+                for (size_t i = 0; i < bpp; i++) cur[i] += prev[i];
+                for (size_t i = bpp; i < rowBytes; i++) {
+                    int a = cur[i - bpp], b = prev[i], c = prev[i - bpp];
+                    int p = a + b - c;
+                    int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+                    cur[i] += (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+                }
+                break;
+            default:
+                return false;
+        }
+        return true;
+    }
+
+    // 第 i 个样本的原始值（按位深解包）
+    uint32_t sample(const unsigned char* in, size_t i) const {
+        switch (bitDepth) {
+            case 16: return readBE16(in + 2 * i);
+            case 8: return in[i];
+            default: {
+                size_t bit = i * bitDepth;
+                return (in[bit / 8] >> (8 - bitDepth - bit % 8)) & ((1u << bitDepth) - 1);
+            }
+        }
+    }
+
+    // 样本换算到 8 位：16 位取高字节，灰度的低位深按比例放大（与 stb_image 相同）
+    unsigned char scaled(uint32_t value) const {
+        switch (bitDepth) {
+            case 16: return static_cast<unsigned char>(value >> 8);
+            case 4: return static_cast<unsigned char>(value * 0x11);
+            case 2: return static_cast<unsigned char>(value * 0x55);
+            case 1: return static_cast<unsigned char>(value * 0xFF);
+            default: return static_cast<unsigned char>(value);
+        }
+    }
+
+    void expand(const unsigned char* in, unsigned char* out) const {
+        int w = imageWidth;
+        int c = imageChannels;
+        if (colorType == 3) {
+            for (int x = 0; x < w; x++) {
+                std::memcpy(out + c * x, &palette[4 * sample(in, x)], c);
+            }
+            return;
+        }
+        if (bitDepth == 8 && !hasKey) {
+            std::memcpy(out, in, static_cast<size_t>(w) * c);
+            return;
+        }
+        int s = samplesPerPixel;
+        for (int x = 0; x < w; x++) {
+            bool transparent = hasKey;
+            for (int k = 0; k < s; k++) {
+                uint32_t value = sample(in, static_cast<size_t>(x) * s + k);
+                transparent = transparent && value == transparentKey[k];
+                out[c * x + k] = scaled(value);
+            }
+            if (hasKey) {
+                out[c * x + s] = transparent ? 0 : 255;
+            }
+        }
+    }
+
+    std::unique_ptr<ByteReader> reader;
+    z_stream stream{};
+    bool streamReady = false;
+    uint32_t chunkRemaining = 0;
+
+    int bitDepth = 8;
+    int colorType = 0;
+    int samplesPerPixel = 1;
+    size_t rowBytes = 0;
+    std::vector<unsigned char> current;    // 滤波类型 + 当前行
+    std::vector<unsigned char> previous;   // 上一行（反滤波后）
+    std::vector<unsigned char> palette;    // 256 项 RGBA
+    bool hasKey = false;
+    uint32_t transparentKey[3] = {};
+    int nextY = 0;
+};
+
+#endif
+
+bool hasExtension(const std::string& filename, const char* extension) {
+    size_t n = std::strlen(extension);
+    if (filename.size() < n) {
+        return false;
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (std::tolower(static_cast<unsigned char>(filename[filename.size() - n + i])) != extension[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Decoder>
+std::unique_ptr<RowDecoder> openWith(std::unique_ptr<ByteReader> reader) {
+    auto decoder = std::make_unique<Decoder>(std::move(reader));
+    if (!decoder->readHeader()) {
+        return nullptr;
+    }
+    return decoder;
+}
+
+// 按文件头选择解码器
+std::unique_ptr<RowDecoder> openReader(std::unique_ptr<ByteReader> reader, const std::string& filename) {
+    const unsigned char* magic = reader->peek(8);
+    if (!magic) {
+        return nullptr;
+    }
+
+    static const unsigned char PngSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    if (std::memcmp(magic, PngSignature, 8) == 0) {
+#ifdef HAS_ZLIB
+        return openWith<PngDecoder>(std::move(reader));
+#else
+        return nullptr;
+#endif
+    }
+    if (magic[0] == 'B' && magic[1] == 'M') {
+        return openWith<BmpDecoder>(std::move(reader));
+    }
+    if (magic[0] == 'P' && (magic[1] == '5' || magic[1] == '6')) {
+        return openWith<PnmDecoder>(std::move(reader));
+    }
+    // TGA 没有文件签名，只按扩展名识别
+    if (hasExtension(filename, ".tga")) {
+        return openWith<TgaDecoder>(std::move(reader));
+    }
+    return nullptr;
+}
+
+}
+
+std::unique_ptr<RowDecoder> RowDecoder::open(const std::string& filename) {
+    std::FILE* file = std::fopen(filename.c_str(), "rb");
+    if (!file) {
+        return nullptr;
+    }
+    return openReader(std::make_unique<ByteReader>(file), filename);
+}
+
+std::unique_ptr<RowDecoder> RowDecoder::open(const unsigned char* data, size_t size, const std::string& filename) {
+    if (!data) {
+        return nullptr;
+    }
+    return openReader(std::make_unique<ByteReader>(data, size), filename);
+}
+
+const unsigned char* RowDecoder::nextRowData(unsigned char* row, int& y) {
+    return nextRow(row, y) ? row : nullptr;
+}
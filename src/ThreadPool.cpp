@@ -0,0 +1,186 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace {
+
+// 标记当前线程是否正在执行 parallelFor 的任务，用于把嵌套调用降级为串行
+thread_local bool insideParallelFor = false;
+
+}
+
+ThreadPool::ThreadPool(int threadCount) {
+    start(threadCount);
+}
+
+ThreadPool::~ThreadPool() {
+    stop();
+}
+
+int ThreadPool::hardwareThreads() {
+    unsigned int n = std::thread::hardware_concurrency();
+    return n > 0 ? static_cast<int>(n) : 1;
+}
+
+ThreadPool& ThreadPool::global() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::start(int count) {
+    if (count <= 0) {
+        count = hardwareThreads();
+    }
+    stopping = false;
+    // 新线程从当前代数开始等待，避免错过紧接着提交的任务
+    uint64_t startGeneration = generation;
+    for (int i = 1; i < count; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, startGeneration);
+    }
+}
+
+void ThreadPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+void ThreadPool::setThreadCount(int count) {
+    if (count <= 0) {
+        count = hardwareThreads();
+    }
+    std::lock_guard<std::mutex> submitLock(submitMutex);
+    if (count == threadCount()) {
+        return;
+    }
+    stop();
+    start(count);
+}
+
+void ThreadPool::workerLoop(uint64_t seen) {
+    while (true) {
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait(lock, [&] { return stopping || generation != seen; });
+        if (stopping) {
+            return;
+        }
+        seen = generation;
+        lock.unlock();
+
+        if (everyThread) {
+            runOnce();
+        } else {
+            runChunks();
+        }
+
+        lock.lock();
+        if (--busyWorkers == 0) {
+            done.notify_all();
+        }
+    }
+}
+
+void ThreadPool::runChunks() {
+    insideParallelFor = true;
+    while (true) {
+        int chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+        long long first = jobBegin + static_cast<long long>(chunk) * jobGrain;
+        if (first >= jobEnd) {
+            break;
+        }
+        int last = static_cast<int>(std::min<long long>(first + jobGrain, jobEnd));
+        try {
+            task(static_cast<int>(first), last);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!firstError) {
+                firstError = std::current_exception();
+            }
+        }
+    }
+    insideParallelFor = false;
+}
+
+void ThreadPool::runOnce() {
+    insideParallelFor = true;
+    try {
+        task(0, 1);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!firstError) {
+            firstError = std::current_exception();
+        }
+    }
+    insideParallelFor = false;
+}
+
+void ThreadPool::run(int begin, int end, int grain, const Task& fn) {
+    if (end <= begin) {
+        return;
+    }
+
+    int count = end - begin;
+    if (grain <= 0) {
+        // 每个线程约分到4块，兼顾负载均衡与调度开销
+        grain = std::max(1, count / (threadCount() * 4));
+    }
+
+    if (workers.empty() || count <= grain || insideParallelFor) {
+        fn(begin, end);
+        return;
+    }
+
+    std::lock_guard<std::mutex> submitLock(submitMutex);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobBegin = begin;
+        jobEnd = end;
+        jobGrain = grain;
+        nextChunk.store(0, std::memory_order_relaxed);
+    }
+    submit(fn, false);
+    runChunks();
+    finish();
+}
+
+void ThreadPool::broadcast(const Task& fn) {
+    if (workers.empty() || insideParallelFor) {
+        fn(0, 1);
+        return;
+    }
+
+    std::lock_guard<std::mutex> submitLock(submitMutex);
+    submit(fn, true);
+    runOnce();
+    finish();
+}
+
+// 发布任务并唤醒全部工作线程（调用者持有 submitMutex）
+void ThreadPool::submit(const Task& fn, bool once) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = fn;
+        everyThread = once;
+        firstError = nullptr;
+        busyWorkers = static_cast<int>(workers.size());
+        generation++;
+    }
+    wake.notify_all();
+}
+
+// 等待全部工作线程完成当前任务，重新抛出任务中的第一个异常
+void ThreadPool::finish() {
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&] { return busyWorkers == 0; });
+    task = Task{nullptr, nullptr};
+    if (firstError) {
+        std::exception_ptr error = firstError;
+        firstError = nullptr;
+        std::rethrow_exception(error);
+    }
+}
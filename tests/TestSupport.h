@@ -0,0 +1,76 @@
+#ifndef TEST_SUPPORT_H
+#define TEST_SUPPORT_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <filesystem>
+
+#ifdef _WIN32
+    #include <process.h>
+    #define TEST_GETPID _getpid
+#else
+    #include <unistd.h>
+    #define TEST_GETPID getpid
+#endif
+
+// 测试程序共用的检查和辅助函数：检查失败时输出说明并计数，main 返回 testResult()
+namespace TestSupport {
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+inline bool check(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        failures()++;
+    }
+    return condition;
+}
+
+inline int testResult(const char* name) {
+    if (failures() == 0) {
+        std::cout << name << ": all checks passed" << std::endl;
+        return 0;
+    }
+    std::cerr << name << ": " << failures() << " check(s) failed" << std::endl;
+    return 1;
+}
+
+// 临时目录（TMPDIR / TEMP，未设置时为系统临时目录）中本进程专用的文件名
+inline std::string tempPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / ("fft-test-" + std::to_string(TEST_GETPID()) + "-" + name)).string();
+}
+
+// 确定性的伪随机字节
+inline unsigned char patternByte(size_t i, unsigned seed) {
+    unsigned v = static_cast<unsigned>(i) * 2654435761u + seed * 40503u;
+    v ^= v >> 13;
+    v *= 0x5bd1e995u;
+    return static_cast<unsigned char>(v >> 24);
+}
+
+// 写入 8 位二进制 PGM（平滑图案加噪声），返回是否成功
+inline bool writePgm(const std::string& path, int width, int height) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    std::fprintf(file, "P5\n%d %d\n255\n", width, height);
+    std::vector<unsigned char> row(width);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int smooth = (x * 255 / (width > 1 ? width - 1 : 1) + y * 127 / (height > 1 ? height - 1 : 1)) / 2;
+            row[x] = static_cast<unsigned char>(smooth / 2 + patternByte(static_cast<size_t>(y) * width + x, 7) / 2);
+        }
+        std::fwrite(row.data(), 1, row.size(), file);
+    }
+    return std::fclose(file) == 0;
+}
+
+}
+
+#endif // TEST_SUPPORT_H
@@ -0,0 +1,147 @@
+// 截止频率落在环带分界上的理想滤波：频带缓存合成的预览与逐系数滤波的预览在单精度误差内一致；
+// 多个线程同时合成时结果与串行合成相同
+// 内存预算包含构建时各并行任务的临时缓冲区
+#include "TestSupport.h"
+#include "ImageProcessor.h"
+#include "RadialBandCache.h"
+#include "FFT2D.h"
+#include "ThreadPool.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <algorithm>
+
+namespace {
+
+using TestSupport::check;
+
+double maxDifference(const Image<double>& a, const Image<double>& b) {
+    if (a.width() != b.width() || a.height() != b.height()) {
+        return INFINITY;
+    }
+    double diff = 0.0;
+    for (int y = 0; y < a.height(); y++) {
+        for (int x = 0; x < a.width(); x++) {
+            diff = std::max(diff, std::abs(a[y][x] - b[y][x]));
+        }
+    }
+    return diff;
+}
+
+void compare(ImageProcessor& processor, const FilterSpec& spec, const std::string& label) {
+    Image<double> direct = processor.filterPreview(spec);
+    const Image<double>& cached = processor.bandCachePreview(spec);
+    // 环带图像以单精度保存：每幅的误差约为 float 精度 × 像素幅值，K 幅累加
+    double diff = maxDifference(cached, direct);
+    check(diff < 1e-4, label + ": band cache differs from direct filtering by " + std::to_string(diff));
+}
+
+void testImage(int width, int height, int bands) {
+    std::string prefix = std::to_string(width) + "x" + std::to_string(height) + ", " + std::to_string(bands) + " bands";
+    std::string path = TestSupport::tempPath("bands.pgm");
+    ImageProcessor processor;
+    bool loaded = TestSupport::writePgm(path, width, height) && processor.loadImage(path);
+    std::remove(path.c_str());
+    if (!check(loaded, prefix + ": load test image")) {
+        return;
+    }
+    processor.fft2D();
+    if (!check(processor.buildBandCache(bands) && processor.getBandCount() == bands, prefix + ": build band cache")) {
+        return;
+    }
+
+    FilterSpec spec;
+    spec.shape = FilterShape::Ideal;
+    for (int k = 1; k <= bands; k++) {
+        double edge = static_cast<double>(k) / bands;
+        spec.band = FilterBand::LowPass;
+        spec.cutoff = edge;
+        compare(processor, spec, prefix + ", low-pass at " + std::to_string(k) + "/" + std::to_string(bands));
+        spec.band = FilterBand::HighPass;
+        compare(processor, spec, prefix + ", high-pass at " + std::to_string(k) + "/" + std::to_string(bands));
+    }
+    for (int k = 1; k < bands; k += 3) {
+        spec.band = FilterBand::BandPass;
+        spec.bandLow = static_cast<double>(k) / bands;
+        spec.bandHigh = static_cast<double>(std::min(bands, k + 2)) / bands;
+        compare(processor, spec, prefix + ", band-pass from " + std::to_string(k) + "/" + std::to_string(bands));
+    }
+}
+
+// compose 是 const 方法：两个线程同时以不同的传递函数合成，各自的结果必须与串行合成逐位相同
+void testConcurrentCompose() {
+    const int width = 181, height = 97, bands = 12;
+    Image<double> image(width, height);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            image[y][x] = TestSupport::patternByte(static_cast<size_t>(y) * width + x, 9);
+        }
+    }
+    Spectrum<Complex> spectrum;
+    FFT2D::forwardR2C(image, spectrum);
+    RadialBandCache cache;
+    cache.build(spectrum, width, bands, std::sqrt(static_cast<double>(width * width + height * height)) / 2.0);
+
+    FilterSpec specs[2];
+    specs[0].shape = FilterShape::Gaussian;
+    specs[0].band = FilterBand::LowPass;
+    specs[0].cutoff = 0.2;
+    specs[1].shape = FilterShape::Butterworth;
+    specs[1].band = FilterBand::HighPass;
+    specs[1].cutoff = 0.5;
+
+    Image<double> expected[2];
+    cache.compose(specs[0], expected[0]);
+    cache.compose(specs[1], expected[1]);
+
+    bool same[2] = { true, true };
+    auto run = [&](int i) {
+        Image<double> output;
+        for (int repeat = 0; repeat < 50 && same[i]; repeat++) {
+            cache.compose(specs[i], output);
+            for (int y = 0; y < height && same[i]; y++) {
+                same[i] = std::memcmp(output.row(y), expected[i].row(y), width * sizeof(double)) == 0;
+            }
+        }
+    };
+    std::thread first(run, 0), second(run, 1);
+    first.join();
+    second.join();
+    check(same[0] && same[1], "concurrent compose differs from serial compose");
+}
+
+// 内存预算包含构建时各并行任务的临时缓冲区：只够常驻内存和环带图像时拒绝构建
+void testBudget(int width, int height, int bands) {
+    std::string path = TestSupport::tempPath("bands_budget.pgm");
+    ImageProcessor processor;
+    bool loaded = TestSupport::writePgm(path, width, height) && processor.loadImage(path);
+    std::remove(path.c_str());
+    if (!check(loaded, "budget: load test image")) {
+        return;
+    }
+    processor.fft2D();
+    size_t resident = processor.estimateTransformBytes(width, height) + RadialBandCache::estimateBytes(width, height, bands);
+    size_t work = RadialBandCache::buildWorkBytes(width, height, bands, processor.getThreadCount());
+    check(work > 0, "budget: build work bytes");
+    processor.setMemoryBudget(resident + work - 1);
+    check(!processor.buildBandCache(bands), "budget: band cache should not fit without its build buffers");
+    processor.setMemoryBudget(resident + work);
+    check(processor.buildBandCache(bands), "budget: band cache should fit with its build buffers");
+}
+
+}
+
+int main() {
+    testConcurrentCompose();
+    // (W² + H²)·k²/(4K²) 都不是整数：分界圆上没有系数，高通/带通的内侧边界与逐系数滤波一致
+    testImage(300, 257, 16);
+    testImage(301, 200, 10);
+    // 环带数不是任务数的整数倍
+    int threads = ThreadPool::global().threadCount();
+    ThreadPool::global().setThreadCount(4);
+    testImage(301, 200, 10);
+    testBudget(301, 200, 10);
+    ThreadPool::global().setThreadCount(threads);
+    return TestSupport::testResult("band_cache");
+}
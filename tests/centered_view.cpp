@@ -0,0 +1,62 @@
+// CenteredSpectrumView：row() 按两段连续区间展开的中心化行与逐点的 operator() 相同，
+// 且与实数图像的完整 DFT 经 fftShift 后的系数一致（奇偶宽高）
+#include "TestSupport.h"
+#include "FFT2D.h"
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <algorithm>
+
+namespace {
+
+using TestSupport::check;
+
+const double PI = 3.14159265358979323846;
+
+void testSize(int width, int height) {
+    std::string label = std::to_string(width) + "x" + std::to_string(height);
+    Image<double> image(width, height);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            image[y][x] = TestSupport::patternByte(static_cast<size_t>(y) * width + x, 3);
+        }
+    }
+    Spectrum<Complex> half;
+    FFT2D::forwardR2C(image, half);
+    FFT2D::CenteredSpectrumView<double> view(half, width);
+    check(view.width() == width && view.height() == height, label + ": view size");
+
+    std::vector<Complex> row(width);
+    double rowDiff = 0.0, dftDiff = 0.0;
+    for (int y = 0; y < height; y++) {
+        view.row(y, row.data());
+        for (int x = 0; x < width; x++) {
+            Complex single = view(x, y);
+            rowDiff = std::max(rowDiff, std::abs(row[x].real - single.real) + std::abs(row[x].imag - single.imag));
+
+            // 中心化坐标 (x, y) 对应频率 (x - W/2, y - H/2) 的直接 DFT
+            std::complex<double> sum = 0.0;
+            for (int v = 0; v < height; v++) {
+                for (int u = 0; u < width; u++) {
+                    double angle = -2.0 * PI * (static_cast<double>(x - width / 2) * u / width +
+                                                static_cast<double>(y - height / 2) * v / height);
+                    sum += image[v][u] * std::polar(1.0, angle);
+                }
+            }
+            dftDiff = std::max(dftDiff, std::abs(sum - std::complex<double>(row[x].real, row[x].imag)));
+        }
+    }
+    check(rowDiff == 0.0, label + ": row() differs from operator()");
+    check(dftDiff < 1e-8 * width * height * 255, label + ": differs from the direct DFT by " + std::to_string(dftDiff));
+}
+
+}
+
+int main() {
+    for (int width : { 1, 2, 7, 8, 15 }) {
+        for (int height : { 1, 4, 9 }) {
+            testSize(width, height);
+        }
+    }
+    return TestSupport::testResult("centered_view");
+}
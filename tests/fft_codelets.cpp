@@ -0,0 +1,119 @@
+// 混合基 codelet 和使用它们的混合基计划与直接按定义计算的DFT比较
+#include "TestSupport.h"
+#include "FFTCodelets.h"
+#include "FFTPlan.h"
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+namespace {
+
+using TestSupport::check;
+
+// 长双精度按定义计算 N 点DFT
+std::vector<Complex> naiveDFT(const std::vector<Complex>& input) {
+    size_t n = input.size();
+    const long double pi = 3.141592653589793238462643383279502884L;
+    std::vector<Complex> output(n);
+    for (size_t k = 0; k < n; k++) {
+        long double re = 0.0L, im = 0.0L;
+        for (size_t j = 0; j < n; j++) {
+            long double angle = -2.0L * pi * static_cast<long double>((j * k) % n) / static_cast<long double>(n);
+            re += input[j].real * std::cos(angle) - input[j].imag * std::sin(angle);
+            im += input[j].real * std::sin(angle) + input[j].imag * std::cos(angle);
+        }
+        output[k] = Complex(static_cast<double>(re), static_cast<double>(im));
+    }
+    return output;
+}
+
+std::vector<Complex> testSignal(int n, unsigned seed) {
+    std::vector<Complex> signal(n);
+    for (int i = 0; i < n; i++) {
+        signal[i] = Complex(TestSupport::patternByte(2 * i, seed) / 127.5 - 1.0,
+                            TestSupport::patternByte(2 * i + 1, seed) / 127.5 - 1.0);
+    }
+    return signal;
+}
+
+// 相对于结果最大模的误差
+template<typename T>
+double relativeError(const ComplexT<T>* result, const std::vector<Complex>& expected) {
+    double error = 0.0, scale = 0.0;
+    for (size_t k = 0; k < expected.size(); k++) {
+        Complex value(result[k]);
+        error = std::max(error, (value - expected[k]).magnitude());
+        scale = std::max(scale, expected[k].magnitude());
+    }
+    return error / std::max(scale, 1e-300);
+}
+
+// 跨步 codelet：stride 个交错子序列各自与定义比较
+template<typename T>
+void testLeaves(int leaf, int stride, double tolerance) {
+    std::string label = "codelet " + std::to_string(leaf) + " (stride " + std::to_string(stride) +
+                        (sizeof(T) == sizeof(float) ? ", float)" : ", double)");
+    std::vector<Complex> signal = testSignal(leaf * stride, static_cast<unsigned>(leaf));
+    std::vector<ComplexT<T>> data(signal.size());
+    for (size_t i = 0; i < signal.size(); i++) {
+        data[i] = ComplexT<T>(signal[i]);
+    }
+    if (!check(FFTCodelets::stridedLeaves(data.data(), leaf, stride), label + ": size not supported")) {
+        return;
+    }
+    double error = 0.0;
+    for (int q = 0; q < stride; q++) {
+        std::vector<Complex> column(leaf);
+        std::vector<ComplexT<T>> result(leaf);
+        for (int j = 0; j < leaf; j++) {
+            column[j] = Complex(ComplexT<T>(signal[q + static_cast<size_t>(stride) * j]));
+            result[j] = data[q + static_cast<size_t>(stride) * j];
+        }
+        error = std::max(error, relativeError(result.data(), naiveDFT(column)));
+    }
+    check(error < tolerance, label + ": relative error " + std::to_string(error));
+}
+
+// 整个计划：正变换与定义比较，逆变换回到输入
+template<typename T>
+void testPlan(int n, double tolerance) {
+    std::string label = "plan " + std::to_string(n) + (sizeof(T) == sizeof(float) ? " (float)" : " (double)");
+    auto plan = FFTPlanT<T>::get(n);
+    check(plan->algorithm() == FFTPlanT<T>::Algorithm::MixedRadix, label + ": expected a mixed-radix plan");
+
+    std::vector<Complex> signal = testSignal(n, 3);
+    std::vector<ComplexT<T>> data(n);
+    for (int i = 0; i < n; i++) {
+        data[i] = ComplexT<T>(signal[i]);
+    }
+    std::vector<Complex> rounded(n);
+    for (int i = 0; i < n; i++) {
+        rounded[i] = Complex(data[i]);
+    }
+    plan->forward(data.data());
+    double error = relativeError(data.data(), naiveDFT(rounded));
+    check(error < tolerance, label + ": forward relative error " + std::to_string(error));
+
+    plan->inverse(data.data());
+    double roundtrip = relativeError(data.data(), rounded);
+    check(roundtrip < tolerance, label + ": round trip relative error " + std::to_string(roundtrip));
+}
+
+}
+
+int main() {
+    for (int leaf : FFTCodelets::MixedSizes) {
+        for (int stride : {1, 3, 8}) {
+            testLeaves<double>(leaf, stride, 1e-14);
+            testLeaves<float>(leaf, stride, 1e-6);
+        }
+    }
+    check(!FFTCodelets::stridedLeaves<double>(nullptr, 7, 1), "unsupported codelet size is rejected");
+
+    // 只有叶子、叶子前有 4/2/3/5/7 各级、以及较长的序列
+    for (int n : {3, 6, 12, 15, 60, 90, 120, 210, 243, 300, 360, 625, 1000, 2160}) {
+        testPlan<double>(n, 1e-13);
+        testPlan<float>(n, 2e-6);
+    }
+    return TestSupport::testResult("fft_codelets");
+}
@@ -0,0 +1,133 @@
+// SIMD蝶形内核与标量参考实现比较（各指令集级别、double 和 float），
+// 以及单精度变换相对双精度变换的误差上界
+#include "TestSupport.h"
+#include "FFTKernels.h"
+#include "FFTPlan.h"
+#include "ImageProcessor.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include <algorithm>
+
+namespace {
+
+using TestSupport::check;
+
+const double PI = 3.14159265358979323846;
+
+std::string format(double value) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.3g", value);
+    return text;
+}
+
+template<typename T>
+const char* precisionName() {
+    return sizeof(T) == sizeof(float) ? "float" : "double";
+}
+
+// 一级蝶形：各级别的 radix2Pass 与 radix2PassScalar 比较。
+// 带 FMA 的内核舍入方式不同，允许每个输出几个 ulp 的差别（输入分量在 [-1, 1] 内，输出的模不超过 3）
+template<typename T>
+void testPass(SimdLevel level, int n, int half, double tolerance) {
+    std::vector<T> twiddles(2 * half);
+    for (int j = 0; j < half; j++) {
+        twiddles[2 * j] = static_cast<T>(std::cos(-PI * j / half));
+        twiddles[2 * j + 1] = static_cast<T>(std::sin(-PI * j / half));
+    }
+    std::vector<T> data(2 * n), reference;
+    for (int i = 0; i < 2 * n; i++) {
+        data[i] = static_cast<T>(TestSupport::patternByte(i, static_cast<unsigned>(half)) / 127.5 - 1.0);
+    }
+    reference = data;
+
+    FFTKernels::radix2Pass(data.data(), twiddles.data(), n, half);
+    FFTKernels::radix2PassScalar(reference.data(), twiddles.data(), n, half);
+
+    double diff = 0.0;
+    for (int i = 0; i < 2 * n; i++) {
+        diff = std::max(diff, std::abs(static_cast<double>(data[i]) - static_cast<double>(reference[i])));
+    }
+    check(diff <= tolerance, std::string(FFTKernels::simdLevelName(level)) + " " + precisionName<T>() +
+                                 " pass n=" + std::to_string(n) + " half=" + std::to_string(half) +
+                                 " differs from scalar by " + format(diff));
+}
+
+// 整个 radix-2 计划：当前级别与标量级别的结果比较（相对于最大幅值）
+template<typename T>
+std::vector<ComplexT<T>> planResult(int n) {
+    std::vector<ComplexT<T>> data(n);
+    for (int i = 0; i < n; i++) {
+        data[i] = ComplexT<T>(static_cast<T>(TestSupport::patternByte(2 * i, 5) / 127.5 - 1.0),
+                              static_cast<T>(TestSupport::patternByte(2 * i + 1, 5) / 127.5 - 1.0));
+    }
+    FFTPlanT<T>::get(n)->forward(data.data());
+    return data;
+}
+
+template<typename T>
+double relativeDifference(const std::vector<ComplexT<T>>& a, const std::vector<ComplexT<T>>& b) {
+    double diff = 0.0, scale = 0.0;
+    for (size_t i = 0; i < a.size(); i++) {
+        diff = std::max(diff, static_cast<double>((a[i] - b[i]).magnitude()));
+        scale = std::max(scale, static_cast<double>(b[i].magnitude()));
+    }
+    return diff / scale;
+}
+
+}
+
+int main() {
+    SimdLevel original = FFTKernels::activeSimdLevel();
+    SimdLevel highest = FFTKernels::detectSimdLevel();
+    std::cout << "CPU SIMD level: " << FFTKernels::simdLevelName(highest) << std::endl;
+
+    const int planSizes[] = { 128, 4096, 1 << 16 };
+    std::vector<std::vector<Complex>> scalarD;
+    std::vector<std::vector<ComplexF>> scalarF;
+    for (int level = 0; level <= static_cast<int>(highest); level++) {
+        SimdLevel simd = FFTKernels::setSimdLevel(static_cast<SimdLevel>(level));
+        check(simd == static_cast<SimdLevel>(level), "setSimdLevel to a supported level");
+
+        // 所有半长，包括小于向量宽度、需要降级的级
+        for (int n : { 2, 16, 64, 1024 }) {
+            for (int half = 1; half < n; half *= 2) {
+                testPass<double>(simd, n, half, 4e-15);
+                testPass<float>(simd, n, half, 2e-6);
+            }
+        }
+
+        for (size_t i = 0; i < std::size(planSizes); i++) {
+            std::vector<Complex> resultD = planResult<double>(planSizes[i]);
+            std::vector<ComplexF> resultF = planResult<float>(planSizes[i]);
+            if (level == 0) {
+                scalarD.push_back(resultD);
+                scalarF.push_back(resultF);
+                continue;
+            }
+            std::string label = std::string(FFTKernels::simdLevelName(simd)) + " plan n=" + std::to_string(planSizes[i]);
+            double diffD = relativeDifference(resultD, scalarD[i]);
+            double diffF = relativeDifference(resultF, scalarF[i]);
+            check(diffD < 1e-14, label + " (double) differs from scalar by " + format(diffD));
+            check(diffF < 1e-5, label + " (float) differs from scalar by " + format(diffF));
+        }
+    }
+    FFTKernels::setSimdLevel(original);
+
+    // 单精度二维变换相对双精度的误差：频谱误差约为 float 的机器精度乘以 log2(N) 量级
+    std::string path = TestSupport::tempPath("precision.pgm");
+    ImageProcessor processor;
+    bool loaded = TestSupport::writePgm(path, 512, 384) && processor.loadImage(path);
+    std::remove(path.c_str());
+    if (check(loaded, "load test image")) {
+        PrecisionReport report = processor.comparePrecision();
+        check(report.valid, "precision comparison");
+        check(report.spectrumRmsError < 1e-6, "float spectrum RMS error " + format(report.spectrumRmsError));
+        check(report.spectrumMaxError < 1e-5, "float spectrum max error " + format(report.spectrumMaxError));
+        check(report.roundtripMaxError < 1e-3, "float round trip max pixel error " + format(report.roundtripMaxError));
+        std::cout << "float vs double: spectrum RMS " << report.spectrumRmsError << ", max "
+                  << report.spectrumMaxError << ", round trip " << report.roundtripMaxError << " (PSNR "
+                  << report.roundtripPSNR << " dB)" << std::endl;
+    }
+    return TestSupport::testResult("fft_kernels");
+}
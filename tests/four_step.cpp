@@ -0,0 +1,123 @@
+// 四步法（n ≥ FourStepThreshold）与 radix-2 / Stockham 路径比较：
+// 参考结果用一级按时间抽取，把长度 n = r·m 拆成 r 个长度 m 的子变换（m 低于阈值，走普通计划），
+// 再用双精度旋转因子合并 X[k] = Σ_j W_n^{jk}·F_j[k mod m]
+#include "TestSupport.h"
+#include "FFTPlan.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include <algorithm>
+
+namespace {
+
+using TestSupport::check;
+using Plan = FFTPlanT<double>;
+
+const double PI = 3.14159265358979323846;
+
+std::string format(double value) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.3g", value);
+    return text;
+}
+
+const char* algorithmName(Plan::Algorithm algo) {
+    switch (algo) {
+        case Plan::Algorithm::Radix2: return "radix-2";
+        case Plan::Algorithm::MixedRadix: return "Stockham";
+        case Plan::Algorithm::Bluestein: return "Bluestein";
+        case Plan::Algorithm::FourStep: return "four-step";
+    }
+    return "?";
+}
+
+template<typename T>
+std::vector<ComplexT<T>> input(int n) {
+    std::vector<ComplexT<T>> data(n);
+    for (int i = 0; i < n; i++) {
+        data[i] = ComplexT<T>(static_cast<T>(TestSupport::patternByte(2 * i, 11) / 127.5 - 1.0),
+                              static_cast<T>(TestSupport::patternByte(2 * i + 1, 11) / 127.5 - 1.0));
+    }
+    return data;
+}
+
+std::vector<Complex> reference(const std::vector<Complex>& data, int radix) {
+    int n = static_cast<int>(data.size());
+    int m = n / radix;
+    auto sub = Plan::get(m);
+    check(sub->algorithm() != Plan::Algorithm::FourStep,
+          "reference sub-plan m=" + std::to_string(m) + " must not be four-step");
+
+    std::vector<std::vector<Complex>> parts(radix, std::vector<Complex>(m));
+    for (int j = 0; j < radix; j++) {
+        for (int i = 0; i < m; i++) {
+            parts[j][i] = data[static_cast<size_t>(i) * radix + j];
+        }
+        sub->forward(parts[j].data());
+    }
+
+    std::vector<Complex> result(n);
+    for (int k = 0; k < n; k++) {
+        Complex sum = parts[0][k % m];
+        for (int j = 1; j < radix; j++) {
+            long long e = (static_cast<long long>(j) * k) % n;
+            double angle = -2.0 * PI * static_cast<double>(e) / n;
+            sum = sum + Complex(std::cos(angle), std::sin(angle)) * parts[j][k % m];
+        }
+        result[k] = sum;
+    }
+    return result;
+}
+
+template<typename T>
+double relativeDifference(const std::vector<ComplexT<T>>& a, const std::vector<Complex>& b) {
+    double diff = 0.0, scale = 0.0;
+    for (size_t i = 0; i < a.size(); i++) {
+        double re = static_cast<double>(a[i].real) - b[i].real;
+        double im = static_cast<double>(a[i].imag) - b[i].imag;
+        diff = std::max(diff, std::sqrt(re * re + im * im));
+        scale = std::max(scale, b[i].magnitude());
+    }
+    return diff / scale;
+}
+
+void testLength(int n, int radix) {
+    auto plan = Plan::get(n);
+    auto planF = FFTPlanT<float>::get(n);
+    std::string label = "n=" + std::to_string(n);
+    check(plan->algorithm() == Plan::Algorithm::FourStep,
+          label + " uses " + algorithmName(plan->algorithm()) + ", expected four-step");
+    check(planF->algorithm() == FFTPlanT<float>::Algorithm::FourStep, label + " (float) expected four-step");
+
+    std::vector<Complex> original = input<double>(n);
+    std::vector<Complex> expected = reference(original, radix);
+
+    std::vector<Complex> data = original;
+    plan->forward(data.data());
+    double diff = relativeDifference(data, expected);
+    check(diff < 1e-13, label + " four-step differs from " + algorithmName(Plan::get(n / radix)->algorithm()) +
+                            " reference by " + format(diff));
+
+    plan->inverse(data.data());
+    double roundtrip = relativeDifference(data, original);
+    check(roundtrip < 1e-13, label + " four-step round trip error " + format(roundtrip));
+
+    std::vector<ComplexF> dataF = input<float>(n);
+    planF->forward(dataF.data());
+    double diffF = relativeDifference(dataF, expected);
+    check(diffF < 1e-5, label + " (float) four-step differs from reference by " + format(diffF));
+
+    std::cout << label << " (" << radix << " x " << algorithmName(Plan::get(n / radix)->algorithm())
+              << "): double " << format(diff) << ", float " << format(diffF) << std::endl;
+}
+
+}
+
+int main() {
+    const int threshold = Plan::FourStepThreshold;
+    testLength(threshold, 2);              // 2^20：两个 2^19 的 radix-2 子变换
+    testLength(3 * (threshold / 2), 2);    // 3·2^19：两个 3·2^18 的 Stockham 子变换
+    testLength(5 * (threshold / 4), 5);    // 5·2^18：五个 2^18 的 radix-2 子变换
+
+    return TestSupport::testResult("four_step");
+}
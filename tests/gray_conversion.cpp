@@ -0,0 +1,141 @@
+// 灰度转换：各指令集级别的 convertRow 与标量内核逐位相同，Luma 与原公式逐位相同，
+// LinearLight 与 sRGB 解码的参考值一致；覆盖 1~4 通道、奇数宽度以及对齐和不对齐的输出
+#include "TestSupport.h"
+#include "GrayConversion.h"
+#include "FFTKernels.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+namespace {
+
+using TestSupport::check;
+
+std::string format(double value) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.3g", value);
+    return text;
+}
+
+// 原实现的灰度公式
+double lumaReference(const unsigned char* p, int channels) {
+    if (channels < 3) {
+        return static_cast<double>(p[0]);
+    }
+    return 0.299 * p[0] + 0.587 * p[1] + 0.114 * p[2];
+}
+
+long double srgbReference(unsigned char v) {
+    long double c = v / 255.0L;
+    return 255.0L * (c <= 0.04045L ? c / 12.92L : std::pow((c + 0.055L) / 1.055L, 2.4L));
+}
+
+double linearReference(const unsigned char* p, int channels) {
+    if (channels < 3) {
+        return static_cast<double>(srgbReference(p[0]));
+    }
+    return static_cast<double>(0.2126L * srgbReference(p[0]) + 0.7152L * srgbReference(p[1]) +
+                               0.0722L * srgbReference(p[2]));
+}
+
+// 输出缓冲区：offset 为相对 64 字节边界的元素偏移（0 为对齐，会走非临时存储）
+struct Output {
+    std::vector<double> storage;
+    double* data;
+
+    Output(int width, int offset) : storage(width + 16, -1.0) {
+        uintptr_t address = reinterpret_cast<uintptr_t>(storage.data());
+        size_t skip = ((64 - address % 64) % 64) / sizeof(double);
+        data = storage.data() + skip + offset;
+    }
+};
+
+const int Widths[] = { 1, 2, 3, 4, 5, 6, 7, 9, 13, 31, 64, 257 };
+
+// 当前级别下对所有通道数、宽度和对齐方式转换，与 results 中保存的标量结果逐位比较
+void testLevel(SimdLevel level, const GrayConverter& converter, std::vector<std::vector<double>>& results) {
+    size_t index = 0;
+    const bool luma = converter.mode() == GrayMode::Luma;
+    const std::string prefix = std::string(FFTKernels::simdLevelName(level)) + " " + GrayConverter::modeName(converter.mode());
+    for (int channels = 1; channels <= 4; channels++) {
+        for (int width : Widths) {
+            // 源数据从奇数地址开始，末尾不留余量，越界读取会被 ASan 等工具发现
+            std::vector<unsigned char> buffer(static_cast<size_t>(width) * channels + 1);
+            for (size_t i = 0; i < buffer.size(); i++) {
+                buffer[i] = TestSupport::patternByte(i, static_cast<unsigned>(channels * 1000 + width));
+            }
+            const unsigned char* src = buffer.data() + 1;
+            for (int offset : { 0, 1, 3 }) {
+                Output output(width, offset);
+                converter.convertRow(src, width, channels, output.data);
+                std::vector<double> row(output.data, output.data + width);
+                std::string label = prefix + " channels=" + std::to_string(channels) + " width=" +
+                                    std::to_string(width) + " offset=" + std::to_string(offset);
+
+                check(output.data[width] == -1.0, label + ": wrote past the end of the row");
+                if (level == SimdLevel::Scalar) {
+                    results.push_back(row);
+                } else {
+                    check(std::memcmp(row.data(), results[index].data(), width * sizeof(double)) == 0,
+                          label + ": differs from the scalar kernel");
+                }
+                index++;
+
+                int mismatches = 0;
+                double diff = 0.0;
+                for (int x = 0; x < width; x++) {
+                    const unsigned char* pixel = src + static_cast<size_t>(x) * channels;
+                    if (luma) {
+                        double expected = lumaReference(pixel, channels);
+                        mismatches += std::memcmp(&row[x], &expected, sizeof(double)) != 0;
+                    } else {
+                        diff = std::max(diff, std::abs(row[x] - linearReference(pixel, channels)));
+                    }
+                }
+                if (luma) {
+                    check(mismatches == 0, label + ": " + std::to_string(mismatches) + " pixel(s) not bitwise equal to the luma formula");
+                } else {
+                    check(diff < 1e-11, label + ": differs from the sRGB reference by " + format(diff));
+                }
+            }
+        }
+    }
+}
+
+}
+
+int main() {
+    SimdLevel original = FFTKernels::activeSimdLevel();
+    SimdLevel highest = FFTKernels::detectSimdLevel();
+    for (GrayMode mode : { GrayMode::Luma, GrayMode::LinearLight }) {
+        GrayConverter converter(mode);
+        std::vector<std::vector<double>> scalar;
+        for (int level = 0; level <= static_cast<int>(highest); level++) {
+            SimdLevel simd = FFTKernels::setSimdLevel(static_cast<SimdLevel>(level));
+            testLevel(simd, converter, scalar);
+        }
+
+        // 整幅图像（Image 的行按 64 字节对齐）与逐行标量转换相同
+        const int width = 45, height = 11, channels = 3;
+        std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * channels);
+        for (size_t i = 0; i < pixels.size(); i++) {
+            pixels[i] = TestSupport::patternByte(i, 77);
+        }
+        Image<double> image;
+        converter.convert(pixels.data(), width, height, channels, image);
+        FFTKernels::setSimdLevel(SimdLevel::Scalar);
+        std::vector<double> row(width);
+        bool same = image.width() == width && image.height() == height;
+        for (int y = 0; y < height && same; y++) {
+            converter.convertRow(pixels.data() + static_cast<size_t>(y) * width * channels, width, channels, row.data());
+            same = std::memcmp(image.row(y), row.data(), width * sizeof(double)) == 0;
+        }
+        check(same, std::string(GrayConverter::modeName(mode)) + ": convert() differs from scalar convertRow()");
+        FFTKernels::setSimdLevel(original);
+    }
+    FFTKernels::setSimdLevel(original);
+    check(FFTKernels::activeSimdLevel() == original, "SIMD level restored");
+    return TestSupport::testResult("gray_conversion");
+}
@@ -0,0 +1,191 @@
+// 图像加载路径：内存映射的逐行解码（RowDecoder::open(data, size, name) + nextRowData）
+// 与按文件读取的逐行解码、stb_image 三者结果相同；loadImage 经 stb_image 从映射内存解码
+// （JPEG 等不支持逐行解码的格式）与逐行解码得到的灰度图像与参考转换逐位相同；
+// 无法映射的文件（回退到普通读取的情况）不输出错误信息
+#include "TestSupport.h"
+#include "RowDecoder.h"
+#include "MappedFile.h"
+#include "GrayConversion.h"
+#include "ImageProcessor.h"
+#include "stb_image.h"
+#include "stb_image_write.h"
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <functional>
+#include <sstream>
+
+namespace {
+
+using TestSupport::check;
+using Bytes = std::vector<unsigned char>;
+
+Bytes pattern(size_t count, unsigned seed) {
+    Bytes data(count);
+    for (size_t i = 0; i < count; i++) {
+        data[i] = TestSupport::patternByte(i, seed);
+    }
+    return data;
+}
+
+// 用 nextRowData 解码整幅图像；inside 非空时统计直接指向 [inside, inside + size) 的行数
+bool decodeAll(RowDecoder& decoder, Bytes& image, const unsigned char* inside = nullptr, size_t size = 0,
+               int* directRows = nullptr) {
+    size_t rowBytes = static_cast<size_t>(decoder.width()) * decoder.channels();
+    image.assign(rowBytes * decoder.height(), 0);
+    std::vector<int> seen(decoder.height(), 0);
+    Bytes row(rowBytes);
+    for (int i = 0; i < decoder.height(); i++) {
+        int y = -1;
+        const unsigned char* pixels = decoder.nextRowData(row.data(), y);
+        if (!pixels || y < 0 || y >= decoder.height() || seen[y]++ != 0) {
+            return false;
+        }
+        if (directRows && pixels >= inside && pixels < inside + size) {
+            (*directRows)++;
+        }
+        std::memcpy(&image[rowBytes * y], pixels, rowBytes);
+    }
+    return true;
+}
+
+// 文件路径、映射内存和 stb_image 三种方式解码 path 并比较
+void compareDecoders(const std::string& path, const std::string& label, bool expectDirect) {
+    int w = 0, h = 0, c = 0;
+    unsigned char* expected = stbi_load(path.c_str(), &w, &h, &c, 0);
+    if (!check(expected != nullptr, label + ": stb_image cannot load the file")) {
+        return;
+    }
+    size_t bytes = static_cast<size_t>(w) * h * c;
+
+    std::unique_ptr<RowDecoder> fromFile = RowDecoder::open(path);
+    Bytes fileImage;
+    if (check(fromFile != nullptr, label + ": file decoder not available") &&
+        check(decodeAll(*fromFile, fileImage), label + ": file decoding failed")) {
+        check(fileImage.size() == bytes && std::memcmp(fileImage.data(), expected, bytes) == 0,
+              label + ": file decoding differs from stb_image");
+    }
+
+    MappedFile mapped;
+    if (check(mapped.openReadOnly(path), label + ": map the file")) {
+        const unsigned char* data = static_cast<const unsigned char*>(mapped.data());
+        std::unique_ptr<RowDecoder> fromMemory = RowDecoder::open(data, mapped.size(), path);
+        Bytes memoryImage;
+        int directRows = 0;
+        if (check(fromMemory != nullptr, label + ": memory decoder not available") &&
+            check(decodeAll(*fromMemory, memoryImage, data, mapped.size(), &directRows), label + ": memory decoding failed")) {
+            check(memoryImage.size() == bytes && std::memcmp(memoryImage.data(), expected, bytes) == 0,
+                  label + ": memory decoding differs from stb_image");
+            // 8 位 PGM/PPM 的行直接指向映射的内容，其他格式解码到调用者的缓冲区
+            check(directRows == (expectDirect ? h : 0),
+                  label + ": " + std::to_string(directRows) + " of " + std::to_string(h) + " rows point into the mapping");
+        }
+
+        // 截断的内容：解码器必须报告失败，而不是读取 size 之外的数据
+        // （图案数据几乎不可压缩，PNG 的后 10% 也是像素数据，不只是校验和和 IEND 块）
+        for (size_t keep : { mapped.size() / 2, mapped.size() * 9 / 10 }) {
+            Bytes truncated(data, data + keep);
+            std::unique_ptr<RowDecoder> partial = RowDecoder::open(truncated.data(), truncated.size(), path);
+            Bytes partialImage;
+            check(!partial || !decodeAll(*partial, partialImage),
+                  label + ": truncated to " + std::to_string(keep) + " bytes still decodes");
+        }
+    }
+    stbi_image_free(expected);
+}
+
+void testDecoder(const std::string& name, bool expectDirect, const std::function<bool(const char*)>& write) {
+    std::string path = TestSupport::tempPath(name);
+    if (check(write(path.c_str()), name + ": write test file")) {
+        compareDecoders(path, name, expectDirect);
+    }
+    std::remove(path.c_str());
+}
+
+bool writePnm(const char* path, int magic, int w, int h, int maxValue) {
+    std::string header = "P" + std::to_string(magic) + "\n" + std::to_string(w) + " " + std::to_string(h) + "\n" +
+                         std::to_string(maxValue) + "\n";
+    Bytes pixels = pattern(static_cast<size_t>(w) * h * (magic == 6 ? 3 : 1) * (maxValue > 255 ? 2 : 1),
+                           static_cast<unsigned>(magic));
+    std::FILE* file = std::fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = std::fwrite(header.data(), 1, header.size(), file) == header.size() &&
+              std::fwrite(pixels.data(), 1, pixels.size(), file) == pixels.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+// loadImage 得到的灰度图像与 stbi_load 解码后按当前灰度方式逐行转换的结果逐位相同
+void testLoadImage(const std::string& name, GrayMode mode, const std::function<bool(const char*)>& write) {
+    std::string path = TestSupport::tempPath(name);
+    std::string label = name + " (" + GrayConverter::modeName(mode) + ")";
+    int w = 0, h = 0, c = 0;
+    unsigned char* pixels = nullptr;
+    ImageProcessor processor;
+    processor.setGrayMode(mode);
+    if (check(write(path.c_str()), label + ": write test file") &&
+        check((pixels = stbi_load(path.c_str(), &w, &h, &c, 0)) != nullptr, label + ": stb_image cannot load the file") &&
+        check(processor.loadImage(path), label + ": loadImage failed")) {
+        const Image<double>& gray = processor.getGrayImage();
+        bool same = gray.width() == w && gray.height() == h && processor.getOriginalChannels() == c;
+        GrayConverter converter(mode);
+        std::vector<double> row(w);
+        for (int y = 0; y < h && same; y++) {
+            converter.convertRow(pixels + static_cast<size_t>(y) * w * c, w, c, row.data());
+            same = std::memcmp(gray.row(y), row.data(), w * sizeof(double)) == 0;
+        }
+        check(same, label + ": gray image differs from stb_image + GrayConverter");
+    }
+    stbi_image_free(pixels);
+    std::remove(path.c_str());
+}
+
+// 无法映射（空文件、不存在的文件）是 loadImage 预期的回退情况：openReadOnly 不输出信息，只给出原因
+void testMappingFailures() {
+    std::string empty = TestSupport::tempPath("empty.bin");
+    std::FILE* file = std::fopen(empty.c_str(), "wb");
+    check(file && std::fclose(file) == 0, "create empty file");
+    for (const std::string& path : { empty, TestSupport::tempPath("missing.bin") }) {
+        std::ostringstream captured;
+        std::streambuf* original = std::cerr.rdbuf(captured.rdbuf());
+        MappedFile mapped;
+        bool opened = mapped.openReadOnly(path);
+        std::cerr.rdbuf(original);
+        check(!opened && !mapped.isOpen(), path + ": mapping should fail");
+        check(captured.str().empty(), path + ": openReadOnly printed \"" + captured.str() + "\"");
+        check(mapped.failureReason().find(path) != std::string::npos, path + ": failure reason names the file");
+    }
+    std::remove(empty.c_str());
+}
+
+}
+
+int main() {
+    testMappingFailures();
+
+    const int w = 53, h = 29;
+    Bytes rgb = pattern(static_cast<size_t>(w) * h * 3, 1);
+    Bytes rgba = pattern(static_cast<size_t>(w) * h * 4, 2);
+    Bytes gray = pattern(static_cast<size_t>(w) * h, 3);
+
+    testDecoder("gray8.pgm", true, [&](const char* path) { return writePnm(path, 5, w, h, 255); });
+    testDecoder("rgb8.ppm", true, [&](const char* path) { return writePnm(path, 6, w, h, 255); });
+    testDecoder("rgb.bmp", false, [&](const char* path) { return stbi_write_bmp(path, w, h, 3, rgb.data()) != 0; });
+    testDecoder("rgba.tga", false, [&](const char* path) { return stbi_write_tga(path, w, h, 4, rgba.data()) != 0; });
+#ifdef HAS_ZLIB
+    testDecoder("rgb.png", false, [&](const char* path) { return stbi_write_png(path, w, h, 3, rgb.data(), w * 3) != 0; });
+    testDecoder("gray.png", false, [&](const char* path) { return stbi_write_png(path, w, h, 1, gray.data(), w) != 0; });
+#endif
+
+    for (GrayMode mode : { GrayMode::Luma, GrayMode::LinearLight }) {
+        // JPEG 没有逐行解码器，走 stbi_load_from_memory
+        testLoadImage("rgb.jpg", mode, [&](const char* path) { return stbi_write_jpg(path, w, h, 3, rgb.data(), 90) != 0; });
+        testLoadImage("gray.jpg", mode, [&](const char* path) { return stbi_write_jpg(path, w, h, 1, gray.data(), 90) != 0; });
+        // 逐行解码路径
+        testLoadImage("rgba.tga", mode, [&](const char* path) { return stbi_write_tga(path, w, h, 4, rgba.data()) != 0; });
+        testLoadImage("gray8.pgm", mode, [&](const char* path) { return writePnm(path, 5, w, h, 255); });
+    }
+    return TestSupport::testResult("image_loading");
+}
@@ -0,0 +1,174 @@
+// 内存预算极低时 fft2D/ifft2D 走外存变换，结果与内存中的 FFT2D 逐位一致
+#include "TestSupport.h"
+#include "ImageProcessor.h"
+#include "FFT2D.h"
+#include "OutOfCoreFFT.h"
+#include "MappedFile.h"
+#include "FilterChain.h"
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+
+namespace {
+
+using TestSupport::check;
+
+// 两个频谱的最大差值（尺寸不同时返回无穷大）
+double maxDifference(const Spectrum<Complex>& a, const Spectrum<Complex>& b) {
+    if (a.width() != b.width() || a.height() != b.height()) {
+        return INFINITY;
+    }
+    double diff = 0.0;
+    for (int y = 0; y < a.height(); y++) {
+        for (int x = 0; x < a.width(); x++) {
+            diff = std::max(diff, (a[y][x] - b[y][x]).magnitude());
+        }
+    }
+    return diff;
+}
+
+double maxDifference(const Image<double>& a, const Image<double>& b) {
+    if (a.width() != b.width() || a.height() != b.height()) {
+        return INFINITY;
+    }
+    double diff = 0.0;
+    for (int y = 0; y < a.height(); y++) {
+        for (int x = 0; x < a.width(); x++) {
+            diff = std::max(diff, std::abs(a[y][x] - b[y][x]));
+        }
+    }
+    return diff;
+}
+
+void testSize(int width, int height) {
+    std::string label = std::to_string(width) + "x" + std::to_string(height);
+    std::string path = TestSupport::tempPath("ooc.pgm");
+    ImageProcessor processor, inCore;
+    bool loaded = TestSupport::writePgm(path, width, height) && processor.loadImage(path) && inCore.loadImage(path);
+    std::remove(path.c_str());
+    if (!check(loaded, label + ": load test image")) {
+        return;
+    }
+
+    // 内存中的参考结果
+    const Image<double>& gray = processor.getGrayImage();
+    Spectrum<Complex> reference;
+    FFT2D::forwardR2C(gray, reference);
+
+    // 预算为 1 字节：任何尺寸都超出预算，条带取最小的 64 行
+    processor.setMemoryBudget(1);
+    processor.fft2D();
+    if (!check(processor.isSpectrumOutOfCore(), label + ": spectrum should be out of core")) {
+        return;
+    }
+    check(maxDifference(processor.getFrequencyDomain(), reference) == 0.0,
+          label + ": out-of-core fft2D differs from FFT2D::forwardR2C");
+
+    // 直接调用 OutOfCoreFFT，改变条带大小（最小条带、奇数行数的条带、整个图像一个条带）
+    int half = FFT2D::halfWidth(width);
+    size_t rowBytes = Spectrum<Complex>::alignedStride(std::max(half, height)) * sizeof(Complex);
+    const size_t workSizes[] = { 0, 100 * rowBytes, size_t(1) << 30 };
+    for (size_t workBytes : workSizes) {
+        MappedFile file;
+        Spectrum<Complex> spectrum;
+        bool ok = OutOfCoreFFT::forwardR2C(gray, processor.getScratchDirectory(), workBytes, file, spectrum);
+        check(ok && maxDifference(spectrum, reference) == 0.0,
+              label + ": OutOfCoreFFT::forwardR2C differs with " + std::to_string(workBytes) + " work bytes");
+    }
+
+    // 逆变换：全部列，以及只有前 activeColumns 列非零的情况
+    for (int activeColumns : {-1, half, half / 2, 1, 0}) {
+        Spectrum<Complex> input = reference;
+        if (activeColumns >= 0) {
+            for (int y = 0; y < height; y++) {
+                for (int x = activeColumns; x < half; x++) {
+                    input[y][x] = Complex(0.0, 0.0);
+                }
+            }
+        }
+        std::string suffix = " (activeColumns " + std::to_string(activeColumns) + ")";
+
+        Image<double> expected, result;
+        Spectrum<Complex> inverseWork;
+        FFT2D::inverseC2R(input, width, expected, inverseWork, activeColumns);
+        for (size_t workBytes : workSizes) {
+            bool ok = OutOfCoreFFT::inverseC2R(input, width, processor.getScratchDirectory(), workBytes, result,
+                                               activeColumns);
+            check(ok && maxDifference(result, expected) == 0.0,
+                  label + ": OutOfCoreFFT::inverseC2R differs with " + std::to_string(workBytes) + " work bytes" + suffix);
+        }
+
+        // ifft2D 还会把结果限制到 [0, 255]，与预算充足的处理器比较
+        inCore.ifft2D(input, expected, activeColumns);
+        processor.ifft2D(input, result, activeColumns);
+        check(maxDifference(result, expected) == 0.0, label + ": out-of-core ifft2D differs from in-core" + suffix);
+    }
+
+    // 外存频谱本身的往返
+    Image<double> roundtrip;
+    processor.ifft2D(processor.getFrequencyDomain(), roundtrip);
+    check(maxDifference(roundtrip, gray) < 1e-9, label + ": round trip through the out-of-core spectrum");
+}
+
+// 频谱在外存中时，预览改用分块滤波，不分配全尺寸的预览频谱
+void testPreviews(int width, int height) {
+    std::string label = std::to_string(width) + "x" + std::to_string(height);
+    std::string path = TestSupport::tempPath("ooc_preview.pgm");
+    ImageProcessor processor, tiled;
+    bool loaded = TestSupport::writePgm(path, width, height) && processor.loadImage(path) && tiled.loadImage(path);
+    std::remove(path.c_str());
+    if (!check(loaded, label + ": load test image")) {
+        return;
+    }
+
+    // 预算只比全图变换少一个字节：频谱进入外存，小块的分块滤波仍在预算之内
+    processor.setMemoryBudget(processor.estimateTransformBytes(width, height) - 1);
+    processor.setTileSize(64, 8);
+    tiled.setTileSize(64, 8);
+    processor.fft2D();
+    if (!check(processor.isSpectrumOutOfCore(), label + ": spectrum should be out of core")) {
+        return;
+    }
+
+    FilterSpec gaussian;
+    gaussian.shape = FilterShape::Gaussian;
+    gaussian.cutoff = 0.3;
+    Image<double> expected;
+    check(tiled.filterTiled(gaussian, expected), label + ": tiled reference");
+    check(maxDifference(processor.filterPreview(gaussian), expected) == 0.0,
+          label + ": out-of-core filterPreview differs from filterTiled");
+
+    FilterSpec ideal;
+    ideal.band = FilterBand::HighPass;
+    ideal.cutoff = 0.2;
+    check(tiled.filterTiled(ideal, expected), label + ": tiled ideal reference");
+    check(maxDifference(processor.highPassPreview(0.2), expected) == 0.0,
+          label + ": out-of-core highPassPreview differs from filterTiled");
+
+    check(maxDifference(processor.unfilteredPreview(), processor.getGrayImage()) == 0.0,
+          label + ": out-of-core unfilteredPreview should be the gray image");
+
+    FilterChain chain;
+    chain.addRadial(gaussian);
+    check(processor.filterChainPreview(chain).empty(), label + ": out-of-core filterChainPreview should fail");
+
+    // 分块滤波同样超出预算时返回空图像
+    processor.setMemoryBudget(1);
+    check(processor.filterPreview(gaussian).empty(), label + ": filterPreview over budget should fail");
+}
+
+}
+
+int main() {
+    // 奇数、素数（Bluestein）、矩形、单行/单列和多个 64 行条带（末条带不满）的尺寸
+    const int sizes[][2] = {
+        {1, 1}, {1, 70}, {70, 1}, {17, 13}, {64, 64}, {97, 131},
+        {128, 200}, {200, 65}, {251, 127}, {300, 257}
+    };
+    for (const auto& size : sizes) {
+        testSize(size[0], size[1]);
+    }
+    testPreviews(300, 257);
+    testPreviews(97, 131);
+    return TestSupport::testResult("out_of_core_fft");
+}
@@ -0,0 +1,117 @@
+// 同一尺寸下重复的滤波预览不分配堆内存（替换全局 operator new 计数）
+#include "TestSupport.h"
+#include "ImageProcessor.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<bool> counting{false};
+std::atomic<long> allocations{0};
+
+void* allocate(std::size_t size) {
+    if (counting.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    return std::malloc(size ? size : 1);
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+    if (counting.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+#ifdef _WIN32
+    return _aligned_malloc(size ? size : 1, static_cast<std::size_t>(alignment));
+#else
+    void* p = nullptr;
+    return posix_memalign(&p, static_cast<std::size_t>(alignment), size ? size : 1) == 0 ? p : nullptr;
+#endif
+}
+
+void releaseAligned(void* p) {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+}
+
+void* operator new(std::size_t size) {
+    if (void* p = allocate(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) {
+    if (void* p = allocate(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    if (void* p = allocateAligned(size, alignment)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    if (void* p = allocateAligned(size, alignment)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { releaseAligned(p); }
+
+namespace {
+
+void runPreviews(ImageProcessor& processor, int rounds) {
+    for (int i = 0; i < rounds; i++) {
+        double shift = 0.02 * (i % 5);
+        processor.lowPassPreview(0.2 + shift);
+        processor.highPassPreview(0.3 + shift);
+        processor.bandPassPreview(0.1 + shift, 0.5 + shift);
+    }
+}
+
+}
+
+int main() {
+    using TestSupport::check;
+    // 奇数和非 2 的幂尺寸走混合基 / Bluestein 计划
+    const int width = 300, height = 257;
+    std::string path = TestSupport::tempPath("alloc.pgm");
+    if (!check(TestSupport::writePgm(path, width, height), "write test image")) {
+        return TestSupport::testResult("preview_allocations");
+    }
+
+    ImageProcessor processor;
+    bool loaded = processor.loadImage(path);
+    std::remove(path.c_str());
+    if (!check(loaded, "load test image")) {
+        return TestSupport::testResult("preview_allocations");
+    }
+
+    for (int threads : {1, 4}) {
+        for (Precision precision : {Precision::Double, Precision::Float}) {
+            processor.setThreadCount(threads);
+            processor.setPrecision(precision);
+            processor.fft2D();
+            // 第一轮预览建立工作区、线程局部缓冲区和滤波几何缓存
+            runPreviews(processor, 5);
+
+            allocations = 0;
+            counting = true;
+            runPreviews(processor, 20);
+            counting = false;
+
+            long count = allocations.load();
+            check(count == 0, std::to_string(count) + " heap allocations in 60 previews (" + std::to_string(threads) +
+                                  " threads, " + (precision == Precision::Float ? "float" : "double") + ")");
+        }
+    }
+    return TestSupport::testResult("preview_allocations");
+}
@@ -0,0 +1,63 @@
+// PreviewWorker：运行期间被新任务取代的任务即使返回 true，其结果也不会交给 GUI 线程
+#include "TestSupport.h"
+#include "PreviewWorker.h"
+#include <atomic>
+#include <thread>
+
+namespace {
+
+using TestSupport::check;
+
+template<typename Condition>
+void spinUntil(const Condition& condition) {
+    while (!condition()) {
+        std::this_thread::yield();
+    }
+}
+
+}
+
+int main() {
+    PreviewWorker worker;
+    std::atomic<bool> firstStarted{false};
+    std::atomic<bool> secondStarted{false};
+    std::atomic<bool> releaseSecond{false};
+
+    // 第一个任务等到被取代后仍报告完成
+    worker.submit([&](PreviewResult& result, const PreviewWorker::Token& token) {
+        firstStarted = true;
+        spinUntil([&] { return token.cancelled(); });
+        result.level = 1;
+        return true;
+    });
+    spinUntil([&] { return firstStarted.load(); });
+
+    worker.submit([&](PreviewResult& result, const PreviewWorker::Token&) {
+        secondStarted = true;
+        spinUntil([&] { return releaseSecond.load(); });
+        result.level = 2;
+        return true;
+    });
+    // 第二个任务开始时第一个任务已经结束
+    spinUntil([&] { return secondStarted.load(); });
+    check(!worker.poll(), "a superseded job's result must not be published");
+
+    releaseSecond = true;
+    worker.waitIdle();
+    check(worker.poll() && worker.result().level == 2, "the latest job's result is published");
+    check(!worker.poll(), "a result is only returned once");
+
+    // 被 cancelAndWait() 取消的任务同样不留下结果
+    std::atomic<bool> thirdStarted{false};
+    worker.submit([&](PreviewResult& result, const PreviewWorker::Token& token) {
+        thirdStarted = true;
+        spinUntil([&] { return token.cancelled(); });
+        result.level = 3;
+        return true;
+    });
+    spinUntil([&] { return thirdStarted.load(); });
+    worker.cancelAndWait();
+    check(!worker.poll(), "a cancelled job's result must not be published");
+
+    return TestSupport::testResult("preview_worker");
+}
@@ -0,0 +1,60 @@
+// RadialTransferLUT：表内的 d² 与逐点求值一致，超出建表范围的 d² 取表尾的值
+#include "TestSupport.h"
+#include "RadialFilter.h"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+using TestSupport::check;
+
+void testTable(const FilterSpec& spec, double radiusScale, long long maxSquared, const std::string& name) {
+    std::string label = name + " (max d² " + std::to_string(maxSquared) + ")";
+    RadialTransferLUT lut;
+    lut.build(spec, radiusScale, maxSquared);
+
+    // 表内：精确部分逐项相等，量化部分为线性插值
+    double diff = 0.0;
+    long long stepSize = std::max(1LL, maxSquared / 4096);
+    for (long long d2 = 0; d2 <= maxSquared; d2 += stepSize) {
+        double expected = RadialTransferLUT::evaluate(spec, radiusScale, std::sqrt(static_cast<double>(d2)));
+        double value = lut(d2);
+        if (d2 < RadialTransferLUT::ExactSize) {
+            check(value == expected || (expected < RadialTransferLUT::TailEpsilon && value == 0.0),
+                  label + ": exact entry " + std::to_string(d2));
+        } else {
+            diff = std::max(diff, std::abs(value - expected));
+        }
+    }
+    check(diff < 1e-4, label + ": interpolated entries differ by " + std::to_string(diff));
+
+    // 超出建表范围：取表尾的值
+    double last = lut(maxSquared);
+    for (long long d2 : {maxSquared + 1, maxSquared + 101, maxSquared + RadialTransferLUT::ExactSize,
+                         4 * maxSquared + 2 * RadialTransferLUT::ExactSize}) {
+        check(lut(d2) == last, label + ": d² " + std::to_string(d2) + " past the table");
+    }
+}
+
+}
+
+int main() {
+    FilterSpec gaussian;
+    gaussian.shape = FilterShape::Gaussian;
+    gaussian.band = FilterBand::HighPass;
+    gaussian.cutoff = 0.4;
+
+    FilterSpec butterworth;
+    butterworth.shape = FilterShape::Butterworth;
+    butterworth.band = FilterBand::LowPass;
+    butterworth.cutoff = 0.6;
+    butterworth.order = 3;
+
+    // 只有精确部分（含只有一项）、精确部分刚好填满、带量化部分
+    for (long long maxSquared : {0LL, 5000LL, RadialTransferLUT::ExactSize - 1LL, 200000LL}) {
+        double radiusScale = std::sqrt(static_cast<double>(maxSquared) + 1.0);
+        testTable(gaussian, radiusScale, maxSquared, "gaussian high-pass");
+        testTable(butterworth, radiusScale, maxSquared, "butterworth low-pass");
+    }
+    return TestSupport::testResult("radial_transfer");
+}
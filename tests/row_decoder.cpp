@@ -0,0 +1,404 @@
+// RowDecoder 与 stb_image 比较：对各种格式变体逐行解码的结果必须与 stbi_load 逐字节相同
+#include "TestSupport.h"
+#include "RowDecoder.h"
+#include "stb_image.h"
+#include "stb_image_write.h"
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <functional>
+#ifdef HAS_ZLIB
+    #include <zlib.h>
+#endif
+
+namespace {
+
+using TestSupport::check;
+using Bytes = std::vector<unsigned char>;
+
+bool writeFile(const std::string& path, const Bytes& data) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+void putLE16(Bytes& out, uint32_t v) {
+    out.push_back(static_cast<unsigned char>(v));
+    out.push_back(static_cast<unsigned char>(v >> 8));
+}
+
+void putLE32(Bytes& out, uint32_t v) {
+    putLE16(out, v & 0xFFFF);
+    putLE16(out, v >> 16);
+}
+
+void putBE32(Bytes& out, uint32_t v) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<unsigned char>(v >> shift));
+    }
+}
+
+// 伪随机像素字节
+Bytes pattern(size_t count, unsigned seed) {
+    Bytes data(count);
+    for (size_t i = 0; i < count; i++) {
+        data[i] = TestSupport::patternByte(i, seed);
+    }
+    return data;
+}
+
+// 逐行解码 path，与期望的 w × h × c 像素逐字节比较
+void compareRows(const std::string& path, const std::string& label, const unsigned char* expected, int w, int h, int c) {
+    std::unique_ptr<RowDecoder> decoder = RowDecoder::open(path);
+    if (!check(decoder != nullptr, label + ": RowDecoder does not accept the file") ||
+        !check(decoder->width() == w && decoder->height() == h && decoder->channels() == c,
+               label + ": size or channels differ from the reference")) {
+        return;
+    }
+    size_t rowBytes = static_cast<size_t>(w) * c;
+    Bytes image(rowBytes * h), row(rowBytes);
+    std::vector<int> seen(h, 0);
+    bool ok = true;
+    for (int i = 0; i < h && ok; i++) {
+        int y = -1;
+        ok = decoder->nextRow(row.data(), y) && y >= 0 && y < h && seen[y]++ == 0;
+        if (ok) {
+            std::memcpy(&image[rowBytes * y], row.data(), rowBytes);
+        }
+    }
+    if (check(ok, label + ": row decoding failed (" + decoder->failureReason() + ")")) {
+        check(std::memcmp(image.data(), expected, image.size()) == 0, label + ": pixels differ from the reference");
+    }
+}
+
+// 以 stbi_load 的结果为参照
+void compareWithStb(const std::string& path, const std::string& label) {
+    int w = 0, h = 0, c = 0;
+    unsigned char* expected = stbi_load(path.c_str(), &w, &h, &c, 0);
+    if (check(expected != nullptr, label + ": stb_image cannot load the file")) {
+        compareRows(path, label, expected, w, h, c);
+    }
+    stbi_image_free(expected);
+}
+
+// 写入文件、比较、删除
+void testFile(const std::string& name, const Bytes& data) {
+    std::string path = TestSupport::tempPath(name);
+    if (check(writeFile(path, data), name + ": write test file")) {
+        compareWithStb(path, name);
+    }
+    std::remove(path.c_str());
+}
+
+void testWritten(const std::string& name, const std::function<int(const char*)>& write) {
+    std::string path = TestSupport::tempPath(name);
+    if (check(write(path.c_str()) != 0, name + ": stb_image_write failed")) {
+        compareWithStb(path, name);
+    }
+    std::remove(path.c_str());
+}
+
+// ---------------------------------------------------------------------------
+// PNM
+
+Bytes makePnm(int magic, int w, int h, int maxValue, unsigned seed) {
+    std::string header = "P" + std::to_string(magic) + "\n# comment\n" + std::to_string(w) + " " +
+                         std::to_string(h) + "\n" + std::to_string(maxValue) + "\n";
+    Bytes data(header.begin(), header.end());
+    size_t samples = static_cast<size_t>(w) * h * (magic == 6 ? 3 : 1) * (maxValue > 255 ? 2 : 1);
+    Bytes pixels = pattern(samples, seed);
+    data.insert(data.end(), pixels.begin(), pixels.end());
+    return data;
+}
+
+// maxval 不是 255 时 RowDecoder 有意与 stb_image 不同（stb 忽略 maxval，16 位时只取高字节），
+// 参照值按 maxval 四舍五入换算到 0..255，超出 maxval 的样本按 maxval 处理
+void testScaledPnm(int magic, int maxValue, unsigned seed) {
+    const int w = 37, h = 23, c = magic == 6 ? 3 : 1;
+    std::string name = "p" + std::to_string(magic) + "-" + std::to_string(maxValue) + ".pnm";
+    Bytes file = makePnm(magic, w, h, maxValue, seed);
+    size_t count = static_cast<size_t>(w) * h * c;
+    int sampleBytes = maxValue > 255 ? 2 : 1;
+    const unsigned char* samples = file.data() + file.size() - count * sampleBytes;
+    Bytes expected(count);
+    for (size_t i = 0; i < count; i++) {
+        uint32_t value = sampleBytes == 2 ? (samples[2 * i] << 8 | samples[2 * i + 1]) : samples[i];
+        value = std::min<uint32_t>(value, static_cast<uint32_t>(maxValue));
+        expected[i] = static_cast<unsigned char>((value * 255 + maxValue / 2) / maxValue);
+    }
+    std::string path = TestSupport::tempPath(name);
+    if (check(writeFile(path, file), name + ": write test file")) {
+        compareRows(path, name, expected.data(), w, h, c);
+    }
+    std::remove(path.c_str());
+}
+
+void testPnm() {
+    for (int magic : {5, 6}) {
+        testFile("p" + std::to_string(magic) + "-255.pnm", makePnm(magic, 37, 23, 255, static_cast<unsigned>(magic)));
+        for (int maxValue : {100, 1000, 65535}) {
+            testScaledPnm(magic, maxValue, static_cast<unsigned>(magic + maxValue));
+        }
+    }
+    testFile("p5-1x5.pgm", makePnm(5, 1, 5, 255, 1));
+}
+
+// ---------------------------------------------------------------------------
+// BMP
+
+// 40 字节信息头的 BMP；palette 为 BGRA 表项，masks 非空时写入 BI_BITFIELDS 掩码
+Bytes makeBmp(int w, int h, int bits, const Bytes& palette, const std::vector<uint32_t>& masks, unsigned seed) {
+    size_t rowBytes = (static_cast<size_t>(w) * bits + 31) / 32 * 4;
+    int height = h < 0 ? -h : h;
+    uint32_t offset = 14 + 40 + static_cast<uint32_t>(masks.size() * 4 + palette.size());
+    Bytes out = { 'B', 'M' };
+    putLE32(out, offset + static_cast<uint32_t>(rowBytes * height));
+    putLE32(out, 0);
+    putLE32(out, offset);
+    putLE32(out, 40);
+    putLE32(out, static_cast<uint32_t>(w));
+    putLE32(out, static_cast<uint32_t>(h));
+    putLE16(out, 1);
+    putLE16(out, static_cast<uint32_t>(bits));
+    putLE32(out, masks.empty() ? 0 : 3);
+    putLE32(out, static_cast<uint32_t>(rowBytes * height));
+    putLE32(out, 2835);
+    putLE32(out, 2835);
+    putLE32(out, static_cast<uint32_t>(palette.size() / 4));
+    putLE32(out, 0);
+    for (uint32_t mask : masks) {
+        putLE32(out, mask);
+    }
+    out.insert(out.end(), palette.begin(), palette.end());
+    Bytes pixels = pattern(rowBytes * height, seed);
+    if (bits <= 8) {
+        // 索引不超过调色板项数
+        int entries = static_cast<int>(palette.size() / 4);
+        int perByte = 8 / bits;
+        for (unsigned char& b : pixels) {
+            unsigned char value = 0;
+            for (int k = 0; k < perByte; k++) {
+                value = static_cast<unsigned char>((value << bits) | ((b + 7 * k) % entries));
+            }
+            b = value;
+        }
+    }
+    out.insert(out.end(), pixels.begin(), pixels.end());
+    return out;
+}
+
+void testBmp() {
+    for (int bits : {1, 4, 8}) {
+        int entries = bits == 8 ? 200 : (1 << bits);
+        Bytes palette = pattern(static_cast<size_t>(entries) * 4, static_cast<unsigned>(bits));
+        for (size_t i = 3; i < palette.size(); i += 4) {
+            palette[i] = 0;
+        }
+        testFile("palette" + std::to_string(bits) + ".bmp", makeBmp(29, 17, bits, palette, {}, 11));
+        testFile("palette" + std::to_string(bits) + "-topdown.bmp", makeBmp(30, -9, bits, palette, {}, 12));
+    }
+    testFile("rgb24.bmp", makeBmp(31, 13, 24, {}, {}, 13));
+    testFile("rgb24-topdown.bmp", makeBmp(33, -7, 24, {}, {}, 14));
+    testFile("rgb555.bmp", makeBmp(19, 11, 16, {}, {}, 15));
+    testFile("rgb565.bmp", makeBmp(19, 11, 16, {}, {0xF800, 0x07E0, 0x001F}, 16));
+    testFile("bitfields32.bmp", makeBmp(21, 8, 32, {}, {0x00FF0000, 0x0000FF00, 0x000000FF}, 17));
+
+    const int w = 27, h = 15;
+    Bytes rgb = pattern(static_cast<size_t>(w) * h * 3, 18);
+    Bytes rgba = pattern(static_cast<size_t>(w) * h * 4, 19);
+    testWritten("stb-rgb.bmp", [&](const char* path) { return stbi_write_bmp(path, w, h, 3, rgb.data()); });
+    testWritten("stb-rgba.bmp", [&](const char* path) { return stbi_write_bmp(path, w, h, 4, rgba.data()); });
+}
+
+// ---------------------------------------------------------------------------
+// TGA
+
+// 8 位索引 + 24 位调色板的 TGA，可选 RLE 和自上而下
+Bytes makeIndexedTga(int w, int h, bool rle, bool topDown, unsigned seed) {
+    const int entries = 40;
+    Bytes out = { 0, 1, static_cast<unsigned char>(rle ? 9 : 1) };
+    putLE16(out, 0);
+    putLE16(out, entries);
+    out.push_back(24);
+    putLE16(out, 0);
+    putLE16(out, 0);
+    putLE16(out, static_cast<uint32_t>(w));
+    putLE16(out, static_cast<uint32_t>(h));
+    out.push_back(8);
+    out.push_back(topDown ? 0x20 : 0);
+    Bytes palette = pattern(entries * 3, seed);
+    out.insert(out.end(), palette.begin(), palette.end());
+    Bytes indices = pattern(static_cast<size_t>(w) * h, seed + 1);
+    for (size_t i = 0; i < indices.size(); i++) {
+        // 每 5 个像素重复一次，让 RLE 中既有重复包也有原始包
+        indices[i] = static_cast<unsigned char>(indices[i - i % 5 * (i % 3 == 0)] % entries);
+    }
+    if (!rle) {
+        out.insert(out.end(), indices.begin(), indices.end());
+        return out;
+    }
+    // 包跨行：整幅图像作为一个序列编码
+    for (size_t i = 0; i < indices.size();) {
+        size_t run = 1;
+        while (i + run < indices.size() && run < 128 && indices[i + run] == indices[i]) {
+            run++;
+        }
+        if (run > 1) {
+            out.push_back(static_cast<unsigned char>(0x80 | (run - 1)));
+            out.push_back(indices[i]);
+        } else {
+            size_t count = 1;
+            while (i + count < indices.size() && count < 128 &&
+                   (i + count + 1 >= indices.size() || indices[i + count + 1] != indices[i + count])) {
+                count++;
+            }
+            out.push_back(static_cast<unsigned char>(count - 1));
+            out.insert(out.end(), indices.begin() + i, indices.begin() + i + count);
+            run = count;
+        }
+        i += run;
+    }
+    return out;
+}
+
+void testTga() {
+    const int w = 23, h = 19;
+    for (int comp : {1, 3, 4}) {
+        // 每行前半段为常数，RLE 编码中有重复包
+        Bytes pixels = pattern(static_cast<size_t>(w) * h * comp, static_cast<unsigned>(comp));
+        for (int y = 0; y < h; y++) {
+            for (int x = 1; x < w / 2; x++) {
+                std::memcpy(&pixels[(static_cast<size_t>(y) * w + x) * comp], &pixels[static_cast<size_t>(y) * w * comp], comp);
+            }
+        }
+        for (int rle : {0, 1}) {
+            stbi_write_tga_with_rle = rle;
+            std::string name = "stb-" + std::to_string(comp) + (rle ? "-rle" : "") + ".tga";
+            testWritten(name, [&](const char* path) { return stbi_write_tga(path, w, h, comp, pixels.data()); });
+        }
+    }
+    stbi_write_tga_with_rle = 1;
+    testFile("indexed.tga", makeIndexedTga(w, h, false, false, 21));
+    testFile("indexed-rle.tga", makeIndexedTga(w, h, true, false, 22));
+    testFile("indexed-topdown.tga", makeIndexedTga(w, h, true, true, 23));
+}
+
+// ---------------------------------------------------------------------------
+// PNG
+
+#ifdef HAS_ZLIB
+
+void putChunk(Bytes& out, const char* type, const Bytes& data) {
+    putBE32(out, static_cast<uint32_t>(data.size()));
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    uLong crc = crc32(0L, out.data() + start, static_cast<uInt>(out.size() - start));
+    putBE32(out, static_cast<uint32_t>(crc));
+}
+
+// 非隔行 PNG，所有行用滤波类型 0；压缩数据拆成多个 IDAT 块
+Bytes makePng(int w, int h, int bitDepth, int colorType, const Bytes& palette, const Bytes& transparency, unsigned seed) {
+    int samples = colorType == 2 ? 3 : colorType == 4 ? 2 : colorType == 6 ? 4 : 1;
+    size_t rowBytes = (static_cast<size_t>(w) * samples * bitDepth + 7) / 8;
+    Bytes raw;
+    Bytes pixels = pattern(rowBytes * h, seed);
+    for (int y = 0; y < h; y++) {
+        raw.push_back(0);
+        for (size_t i = 0; i < rowBytes; i++) {
+            unsigned char b = pixels[y * rowBytes + i];
+            if (colorType == 3 && bitDepth == 8) {
+                b = static_cast<unsigned char>(b % (palette.size() / 3));
+            }
+            raw.push_back(b);
+        }
+    }
+    // 第一行的前两个像素设为透明色（16 位关键色的两个字节相同，8 位关键色为 0x00 0xNN）
+    if (!transparency.empty() && colorType != 3) {
+        size_t bytes = static_cast<size_t>(samples) * bitDepth / 8;
+        for (size_t i = 0; i < 2 * bytes; i++) {
+            raw[1 + i] = bitDepth == 16 ? transparency[(i % bytes) / 2 * 2 + 1] : transparency[2 * (i % bytes) + 1];
+        }
+    }
+
+    uLongf compressedSize = compressBound(static_cast<uLong>(raw.size()));
+    Bytes compressed(compressedSize);
+    compress(compressed.data(), &compressedSize, raw.data(), static_cast<uLong>(raw.size()));
+    compressed.resize(compressedSize);
+
+    Bytes out = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    Bytes ihdr;
+    putBE32(ihdr, static_cast<uint32_t>(w));
+    putBE32(ihdr, static_cast<uint32_t>(h));
+    ihdr.insert(ihdr.end(), { static_cast<unsigned char>(bitDepth), static_cast<unsigned char>(colorType), 0, 0, 0 });
+    putChunk(out, "IHDR", ihdr);
+    putChunk(out, "tEXt", Bytes{ 'C', 'o', 'm', 'm', 'e', 'n', 't', 0, 'x' });
+    if (!palette.empty()) {
+        putChunk(out, "PLTE", palette);
+    }
+    if (!transparency.empty()) {
+        putChunk(out, "tRNS", transparency);
+    }
+    for (size_t i = 0; i < compressed.size(); i += 97) {
+        putChunk(out, "IDAT", Bytes(compressed.begin() + i, compressed.begin() + std::min(compressed.size(), i + 97)));
+    }
+    putChunk(out, "IEND", {});
+    return out;
+}
+
+void testPng() {
+    const int w = 35, h = 21;
+    for (int bits : {1, 2, 4, 8, 16}) {
+        testFile("gray" + std::to_string(bits) + ".png", makePng(w, h, bits, 0, {}, {}, static_cast<unsigned>(bits)));
+    }
+    for (int bits : {8, 16}) {
+        std::string suffix = std::to_string(bits) + ".png";
+        testFile("rgb" + suffix, makePng(w, h, bits, 2, {}, {}, 30 + bits));
+        testFile("gray-alpha" + suffix, makePng(w, h, bits, 4, {}, {}, 31 + bits));
+        testFile("rgba" + suffix, makePng(w, h, bits, 6, {}, {}, 32 + bits));
+    }
+    // 透明色
+    testFile("gray8-key.png", makePng(w, h, 8, 0, {}, Bytes{ 0, 0x5A }, 40));
+    testFile("gray16-key.png", makePng(w, h, 16, 0, {}, Bytes{ 0x12, 0x12 }, 41));
+    testFile("rgb8-key.png", makePng(w, h, 8, 2, {}, Bytes{ 0, 0x10, 0, 0x20, 0, 0x30 }, 42));
+    // 调色板，含部分透明的调色板
+    for (int bits : {1, 2, 4, 8}) {
+        int entries = bits == 8 ? 150 : (1 << bits);
+        Bytes palette = pattern(static_cast<size_t>(entries) * 3, 50 + bits);
+        std::string name = "palette" + std::to_string(bits);
+        testFile(name + ".png", makePng(w, h, bits, 3, palette, {}, 60 + bits));
+        Bytes alpha = pattern(static_cast<size_t>(entries / 2 + 1), 70 + bits);
+        testFile(name + "-trns.png", makePng(w, h, bits, 3, palette, alpha, 80 + bits));
+    }
+
+    // stb_image_write 的各种滤波类型（-1 为按行自动选择）
+    for (int comp = 1; comp <= 4; comp++) {
+        Bytes pixels = pattern(static_cast<size_t>(w) * h * comp, 90 + comp);
+        for (int filter = -1; filter <= 4; filter++) {
+            stbi_write_force_png_filter = filter;
+            std::string name = "stb-" + std::to_string(comp) + "-filter" + std::to_string(filter + 1) + ".png";
+            testWritten(name, [&](const char* path) { return stbi_write_png(path, w, h, comp, pixels.data(), w * comp); });
+        }
+    }
+    stbi_write_force_png_filter = -1;
+}
+
+#endif
+
+}
+
+int main() {
+    testPnm();
+    testBmp();
+    testTga();
+#ifdef HAS_ZLIB
+    testPng();
+#endif
+    return TestSupport::testResult("row_decoder");
+}
@@ -0,0 +1,120 @@
+// 分块滤波与逐块按传递函数直接求值的参考实现一致。
+// 块尺寸为偶数、图像尺寸为奇数时，块频谱换算到原图的 d² 可达 (W/2.0)² + (H/2.0)²，
+// 超过按整数除法得到的 (W/2)² + (H/2)²，查找表必须覆盖到这里
+#include "TestSupport.h"
+#include "ImageProcessor.h"
+#include "FFT2D.h"
+#include "ThreadPool.h"
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+
+namespace {
+
+using TestSupport::check;
+
+int reflect(int i, int n) {
+    int period = 2 * n;
+    i %= period;
+    if (i < 0) {
+        i += period;
+    }
+    return i < n ? i : period - 1 - i;
+}
+
+// 与 ImageProcessor::filterTilesRaw 相同的分块方式，增益直接由 RadialTransferLUT::evaluate 求得
+void referenceTiled(const Image<double>& gray, const FilterSpec& spec, int tile, int overlap, Image<double>& output) {
+    int width = gray.width();
+    int height = gray.height();
+    int core = tile - 2 * overlap;
+    int half = FFT2D::halfWidth(tile);
+    double radiusScale = std::sqrt(static_cast<double>(width * width + height * height)) / 2.0;
+    double scaleX = static_cast<double>(width) / tile;
+    double scaleY = static_cast<double>(height) / tile;
+
+    output.resize(width, height);
+    Image<double> block(tile, tile), filtered;
+    Spectrum<Complex> spectrum;
+    for (int y0 = 0; y0 < height; y0 += core) {
+        for (int x0 = 0; x0 < width; x0 += core) {
+            for (int y = 0; y < tile; y++) {
+                for (int x = 0; x < tile; x++) {
+                    block[y][x] = gray[reflect(y0 - overlap + y, height)][reflect(x0 - overlap + x, width)];
+                }
+            }
+            FFT2D::forwardR2C(block, spectrum);
+            for (int y = 0; y < tile; y++) {
+                double ky = FFT2D::centeredOffset(y, tile) * scaleY;
+                for (int x = 0; x < half; x++) {
+                    double kx = x * scaleX;
+                    double d = std::sqrt(static_cast<double>(std::llround(kx * kx + ky * ky)));
+                    double gain = RadialTransferLUT::evaluate(spec, radiusScale, d);
+                    spectrum[y][x] = Complex(spectrum[y][x].real * gain, spectrum[y][x].imag * gain);
+                }
+            }
+            FFT2D::inverseC2R(spectrum, tile, filtered);
+            for (int y = 0; y < std::min(core, height - y0); y++) {
+                for (int x = 0; x < std::min(core, width - x0); x++) {
+                    output[y0 + y][x0 + x] = std::min(255.0, std::max(0.0, filtered[overlap + y][overlap + x]));
+                }
+            }
+        }
+    }
+}
+
+void testTiled(int width, int height, int tile, int overlap, const FilterSpec& spec, const std::string& name) {
+    std::string label = std::to_string(width) + "x" + std::to_string(height) + " tile " + std::to_string(tile) + " " + name;
+    std::string path = TestSupport::tempPath("tiled.pgm");
+    ImageProcessor processor;
+    bool loaded = TestSupport::writePgm(path, width, height) && processor.loadImage(path);
+    std::remove(path.c_str());
+    if (!check(loaded, label + ": load test image")) {
+        return;
+    }
+
+    processor.setTileSize(tile, overlap);
+    Image<double> tiled, expected;
+    if (!check(processor.filterTiled(spec, tiled), label + ": tiled filtering")) {
+        return;
+    }
+    referenceTiled(processor.getGrayImage(), spec, tile, overlap, expected);
+
+    double diff = 0.0;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            diff = std::max(diff, std::abs(tiled[y][x] - expected[y][x]));
+        }
+    }
+    check(diff < 1e-9, label + ": differs from the reference by " + std::to_string(diff));
+}
+
+}
+
+int main() {
+    // 截止半径的平方落在 (W/2)² + (H/2)² 与 (W/2.0)² + (H/2.0)² 之间，角上的系数应当被滤除
+    FilterSpec ideal;
+    ideal.shape = FilterShape::Ideal;
+    ideal.band = FilterBand::LowPass;
+    ideal.cutoff = 0.995;
+
+    FilterSpec gaussian;
+    gaussian.shape = FilterShape::Gaussian;
+    gaussian.band = FilterBand::LowPass;
+    gaussian.cutoff = 0.8;
+
+    const int sizes[][4] = {
+        // 宽、高、块尺寸、重叠
+        {101, 101, 64, 8}, {101, 77, 64, 8}, {97, 131, 48, 4}, {128, 96, 64, 8}, {101, 101, 101, 0}
+    };
+    for (const auto& size : sizes) {
+        testTiled(size[0], size[1], size[2], size[3], ideal, "ideal low-pass");
+        testTiled(size[0], size[1], size[2], size[3], gaussian, "gaussian low-pass");
+    }
+    // 多个工作单元轮流分配块（块数不是工作单元数的整数倍）
+    int threads = ThreadPool::global().threadCount();
+    ThreadPool::global().setThreadCount(3);
+    testTiled(101, 77, 32, 4, gaussian, "gaussian low-pass, 3 threads");
+    testTiled(97, 131, 48, 4, ideal, "ideal low-pass, 3 threads");
+    ThreadPool::global().setThreadCount(threads);
+    return TestSupport::testResult("tiled_filter");
+}